@@ -21,6 +21,9 @@
 
 #include "CommonData.h"
 #include <random>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 
 #include "Exceptions.h"
 
@@ -39,6 +42,220 @@ int fromHexChar(char _i) noexcept
 		return _i - 'A' + 10;
 	return -1;
 }
+
+char const c_hexDigits[] = "0123456789abcdef";
+
+/// Values of the hex digits, 0xff for the other characters
+struct HexValues
+{
+	HexValues()
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			int const v = fromHexChar(char(c));
+			values[c] = v == -1 ? 0xff : byte(v);
+		}
+	}
+	byte values[256];
+};
+
+void hexEncodeScalar(byte const* _data, size_t _size, char* o_hex)
+{
+	for (size_t i = 0; i < _size; i++)
+	{
+		o_hex[2 * i] = c_hexDigits[_data[i] >> 4];
+		o_hex[2 * i + 1] = c_hexDigits[_data[i] & 0x0f];
+	}
+}
+
+bool hexDecodeScalar(char const* _hex, size_t _size, byte* o_data)
+{
+	static HexValues const table;
+	for (size_t i = 0; i < _size; i++)
+	{
+		byte const h = table.values[uint8_t(_hex[2 * i])];
+		byte const l = table.values[uint8_t(_hex[2 * i + 1])];
+		if ((h | l) > 0x0f)
+			return false;
+		o_data[i] = byte(h << 4 | l);
+	}
+	return true;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEV_HEX_SIMD 1
+
+// The vectorised versions are compiled for their instruction sets and are only called
+// when the processor has them
+
+__attribute__((target("ssse3")))
+void hexEncodeSSSE3(byte const* _data, size_t _size, char* o_hex)
+{
+	__m128i const digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	__m128i const lowNibble = _mm_set1_epi8(0x0f);
+	size_t i = 0;
+	for (; i + 16 <= _size; i += 16)
+	{
+		__m128i const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_data + i));
+		__m128i const h = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), lowNibble));
+		__m128i const l = _mm_shuffle_epi8(digits, _mm_and_si128(in, lowNibble));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(o_hex + 2 * i), _mm_unpacklo_epi8(h, l));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(o_hex + 2 * i + 16), _mm_unpackhi_epi8(h, l));
+	}
+	hexEncodeScalar(_data + i, _size - i, o_hex + 2 * i);
+}
+
+/// Values of 16 hex digits. The non hex characters are marked in io_invalid
+__attribute__((target("ssse3")))
+inline __m128i hexValuesSSSE3(__m128i _chars, __m128i& io_invalid)
+{
+	// c - '0' <= 9 and (c | 0x20) - 'a' <= 5 as unsigned bytes, x <= max is min(x, max) == x
+	__m128i const digit = _mm_sub_epi8(_chars, _mm_set1_epi8('0'));
+	__m128i const isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+	__m128i const letter = _mm_sub_epi8(_mm_or_si128(_chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	__m128i const isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+	io_invalid = _mm_or_si128(io_invalid, _mm_xor_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1)));
+	return _mm_or_si128(_mm_and_si128(isDigit, digit),
+		_mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3")))
+bool hexDecodeSSSE3(char const* _hex, size_t _size, byte* o_data)
+{
+	// h * 16 + l of the adjacent digits
+	__m128i const weights = _mm_set1_epi16(0x0110);
+	__m128i invalid = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= _size; i += 16)
+	{
+		__m128i const a = hexValuesSSSE3(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_hex + 2 * i)), invalid);
+		__m128i const b = hexValuesSSSE3(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_hex + 2 * i + 16)), invalid);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(o_data + i),
+			_mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+	}
+	if (_mm_movemask_epi8(invalid))
+		return false;
+	return hexDecodeScalar(_hex + 2 * i, _size - i, o_data + i);
+}
+
+__attribute__((target("avx2")))
+void hexEncodeAVX2(byte const* _data, size_t _size, char* o_hex)
+{
+	__m256i const digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+		'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	__m256i const lowNibble = _mm256_set1_epi8(0x0f);
+	size_t i = 0;
+	for (; i + 32 <= _size; i += 32)
+	{
+		__m256i const in = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_data + i));
+		__m256i const h = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(in, 4), lowNibble));
+		__m256i const l = _mm256_shuffle_epi8(digits, _mm256_and_si256(in, lowNibble));
+		// unpack works within the 128 bit lanes: bytes 0-7 and 16-23, then 8-15 and 24-31
+		__m256i const first = _mm256_unpacklo_epi8(h, l);
+		__m256i const second = _mm256_unpackhi_epi8(h, l);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(o_hex + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(o_hex + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+	hexEncodeSSSE3(_data + i, _size - i, o_hex + 2 * i);
+}
+
+__attribute__((target("avx2")))
+inline __m256i hexValuesAVX2(__m256i _chars, __m256i& io_invalid)
+{
+	__m256i const digit = _mm256_sub_epi8(_chars, _mm256_set1_epi8('0'));
+	__m256i const isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+	__m256i const letter = _mm256_sub_epi8(_mm256_or_si256(_chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	__m256i const isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+	io_invalid = _mm256_or_si256(io_invalid, _mm256_xor_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(-1)));
+	return _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+		_mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2")))
+bool hexDecodeAVX2(char const* _hex, size_t _size, byte* o_data)
+{
+	__m256i const weights = _mm256_set1_epi16(0x0110);
+	__m256i invalid = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 32 <= _size; i += 32)
+	{
+		__m256i const a = hexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(_hex + 2 * i)), invalid);
+		__m256i const b = hexValuesAVX2(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(_hex + 2 * i + 32)), invalid);
+		// pack works within the lanes as well, the 8 byte groups come as a0 b0 a1 b1
+		__m256i const packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(o_data + i), _mm256_permute4x64_epi64(packed, 0xd8));
+	}
+	if (_mm256_movemask_epi8(invalid))
+		return false;
+	return hexDecodeSSSE3(_hex + 2 * i, _size - i, o_data + i);
+}
+#endif
+
+/// The hex conversion for the processor
+struct HexImplementation
+{
+	HexImplementation()
+	{
+		encode = hexEncodeScalar;
+		decode = hexDecodeScalar;
+#if defined(DEV_HEX_SIMD)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			encode = hexEncodeAVX2;
+			decode = hexDecodeAVX2;
+		}
+		else if (__builtin_cpu_supports("ssse3"))
+		{
+			encode = hexEncodeSSSE3;
+			decode = hexDecodeSSSE3;
+		}
+#endif
+	}
+	void (*encode)(byte const*, size_t, char*);
+	bool (*decode)(char const*, size_t, byte*);
+};
+
+HexImplementation const& hexImplementation()
+{
+	static HexImplementation const implementation;
+	return implementation;
+}
+}
+
+void dev::hexEncode(byte const* _data, size_t _size, char* o_hex)
+{
+	hexImplementation().encode(_data, _size, o_hex);
+}
+
+bool dev::hexDecode(char const* _hex, size_t _size, byte* o_data)
+{
+	return hexImplementation().decode(_hex, _size, o_data);
+}
+
+std::string dev::toHex(bytesConstRef _data)
+{
+	std::string hex(_data.size() * 2, '0');
+	hexEncode(_data.data(), _data.size(), &hex[0]);
+	return hex;
+}
+
+std::string dev::toHex(bytes const& _data)
+{
+	return toHex(bytesConstRef(&_data));
+}
+
+std::string dev::toHexPrefixed(bytesConstRef _data)
+{
+	std::string hex(_data.size() * 2 + 2, '0');
+	hex[1] = 'x';
+	hexEncode(_data.data(), _data.size(), &hex[2]);
+	return hex;
+}
+
+std::string dev::toHexPrefixed(bytes const& _data)
+{
+	return toHexPrefixed(bytesConstRef(&_data));
 }
 
 bool dev::isHex(string const& _s) noexcept
@@ -81,31 +298,193 @@ std::string dev::escaped(std::string const& _s, bool _all)
 bytes dev::fromHex(std::string const& _s, WhenError _throw)
 {
 	unsigned s = (_s.size() >= 2 && _s[0] == '0' && _s[1] == 'x') ? 2 : 0;
-	std::vector<uint8_t> ret;
-	ret.reserve((_s.size() - s + 1) / 2);
+	bytes ret((_s.size() - s + 1) / 2);
+	size_t pos = 0;
 
 	if (_s.size() % 2)
 	{
 		int h = fromHexChar(_s[s++]);
 		if (h != -1)
-			ret.push_back(h);
+			ret[pos++] = h;
 		else if (_throw == WhenError::Throw)
 			BOOST_THROW_EXCEPTION(BadHexCharacter());
 		else
 			return bytes();
 	}
-	for (unsigned i = s; i < _s.size(); i += 2)
+	if (hexDecode(_s.data() + s, (_s.size() - s) / 2, ret.data() + pos))
+		return ret;
+	else if (_throw == WhenError::Throw)
+		BOOST_THROW_EXCEPTION(BadHexCharacter());
+	return bytes();
+}
+
+namespace
+{
+/// The hex digits of the big endian bytes of @a _val, at least @a _min bytes
+std::string compactHex(u256 const& _val, unsigned _min, bool _prefixed)
+{
+	byte data[32];
+	// only the significant bytes are exported, a zero is exported as one 0 byte
+	size_t size = boost::multiprecision::export_bits(_val, data, 8) - data;
+	if (!_val)
+		size = 0;
+	size_t const padding = _min > size ? _min - size : 0;
+	size_t const prefix = _prefixed ? 2 : 0;
+	std::string hex(prefix + 2 * (padding + size), '0');
+	if (_prefixed)
+		hex[1] = 'x';
+	hexEncode(data, size, &hex[prefix + 2 * padding]);
+	return hex;
+}
+
+/// cpp_int works on 64 bit limbs where 128 bit multiplication is available, on 32 bit otherwise
+using Limb = boost::multiprecision::limb_type;
+using DoubleLimb = boost::multiprecision::double_limb_type;
+size_t const c_limbCount = 256 / std::numeric_limits<Limb>::digits;
+
+/// The most decimal digits that always fit in a limb, and the power of ten of that many digits
+size_t const c_limbDigits = std::numeric_limits<Limb>::digits10;
+constexpr Limb powerOfTen(size_t _exponent)
+{
+	return _exponent ? 10 * powerOfTen(_exponent - 1) : 1;
+}
+Limb const c_limbBase = powerOfTen(c_limbDigits);
+
+/// The chunk of decimal digits that is read at once
+size_t const c_decimalChunk = 8;
+uint32_t const c_decimalChunkBase = 100000000;
+
+/// u256 of the limbs, the least significant first
+u256 fromLimbs(Limb const (&_limbs)[c_limbCount])
+{
+	u256 value;
+	boost::multiprecision::import_bits(
+		value, _limbs, _limbs + c_limbCount, std::numeric_limits<Limb>::digits, false);
+	return value;
+}
+
+/// Reads 8 decimal digits at once, as the bytes of a 64 bit word.
+/// @returns false if there is a non decimal character
+bool parseDecimalChunk(char const* _digits, uint32_t& o_value)
+{
+	// the first digit goes to the lowest byte, compilers make it one load on little endian
+	byte const* d = reinterpret_cast<byte const*>(_digits);
+	uint64_t v = uint64_t(d[0]) | uint64_t(d[1]) << 8 | uint64_t(d[2]) << 16 | uint64_t(d[3]) << 24 |
+		uint64_t(d[4]) << 32 | uint64_t(d[5]) << 40 | uint64_t(d[6]) << 48 | uint64_t(d[7]) << 56;
+	// '0'..'9' are 0x30..0x39, the high nibble is 3 with and without adding 6
+	uint64_t const high = 0xF0F0F0F0F0F0F0F0;
+	if ((v & high) != 0x3030303030303030 || ((v + 0x0606060606060606) & high) != 0x3030303030303030)
+		return false;
+	v -= 0x3030303030303030;
+	// combine the neighbouring bytes into 2, 4 and 8 digit numbers
+	v = (v * 10 + (v >> 8)) & 0x00FF00FF00FF00FF;
+	v = (v * 100 + (v >> 16)) & 0x0000FFFF0000FFFF;
+	v = (v * 10000 + (v >> 32)) & 0xFFFFFFFF;
+	o_value = uint32_t(v);
+	return true;
+}
+
+/// Reads the digits of a number of up to 19 digits, 8 at once.
+/// @returns false if there is a non decimal character
+bool parseDecimal(char const* _digits, size_t _size, uint64_t& o_value)
+{
+	uint64_t value = 0;
+	size_t i = 0;
+	for (uint32_t chunk; i + c_decimalChunk <= _size; i += c_decimalChunk)
 	{
-		int h = fromHexChar(_s[i]);
-		int l = fromHexChar(_s[i + 1]);
-		if (h != -1 && l != -1)
-			ret.push_back((byte)(h * 16 + l));
-		else if (_throw == WhenError::Throw)
-			BOOST_THROW_EXCEPTION(BadHexCharacter());
-		else
-			return bytes();
+		if (!parseDecimalChunk(_digits + i, chunk))
+			return false;
+		value = value * c_decimalChunkBase + chunk;
 	}
-	return ret;
+	for (; i < _size; i++)
+	{
+		unsigned const digit = unsigned(_digits[i] - '0');
+		if (digit > 9)
+			return false;
+		value = value * 10 + digit;
+	}
+	o_value = value;
+	return true;
+}
+}
+
+std::string dev::toCompactHex(u256 const& _val, unsigned _min)
+{
+	return compactHex(_val, _min, false);
+}
+
+std::string dev::toCompactHexPrefixed(u256 const& _val, unsigned _min)
+{
+	return compactHex(_val, _min, true);
+}
+
+bool dev::hexToU256(char const* _hex, size_t _size, u256& o_value)
+{
+	if (_size > 64)
+		return false;
+	// big endian bytes, the leading ones stay zero
+	byte data[32] = {};
+	byte* const start = data + 32 - (_size + 1) / 2;
+	if (_size % 2)
+	{
+		int const h = fromHexChar(*_hex++);
+		if (h == -1)
+			return false;
+		*start = h;
+	}
+	if (!hexDecode(_hex, _size / 2, start + _size % 2))
+		return false;
+	Limb limbs[c_limbCount];
+	for (size_t i = 0; i < c_limbCount; i++)
+		limbs[i] = fromBigEndian<Limb>(bytesConstRef(data + 32 - sizeof(Limb) * (i + 1), sizeof(Limb)));
+	o_value = fromLimbs(limbs);
+	return true;
+}
+
+bool dev::decimalToU256(char const* _digits, size_t _size, u256& o_value)
+{
+	// 10^77 - 1 is the largest number of 77 digits and less than 2^256
+	if (_size > 77)
+		return false;
+	Limb limbs[c_limbCount] = {};
+	size_t usedLimbs = 0;
+	// the first chunk takes the digits over the whole chunks
+	size_t chunk = _size % c_limbDigits ? _size % c_limbDigits : c_limbDigits;
+	for (size_t pos = 0; pos < _size; pos += chunk, chunk = c_limbDigits)
+	{
+		uint64_t digits;
+		if (!parseDecimal(_digits + pos, chunk, digits))
+			return false;
+		// limbs = limbs * c_limbBase + digits, the carry out of the used limbs is less than c_limbBase
+		DoubleLimb carry = digits;
+		for (size_t i = 0; i < usedLimbs; i++)
+		{
+			carry += DoubleLimb(limbs[i]) * c_limbBase;
+			limbs[i] = Limb(carry);
+			carry >>= std::numeric_limits<Limb>::digits;
+		}
+		if (carry)
+			limbs[usedLimbs++] = Limb(carry);
+	}
+	o_value = usedLimbs > 1 ? fromLimbs(limbs) : u256(limbs[0]);
+	return true;
+}
+
+u256 dev::toU256(std::string const& _s)
+{
+	u256 value;
+	// boost reads a leading 0 as octal, such numbers and anything unusual are left to it
+	if (_s.size() > 2 && _s[0] == '0' && _s[1] == 'x')
+	{
+		if (hexToU256(_s.data() + 2, _s.size() - 2, value))
+			return value;
+	}
+	else if (_s.size() == 1 || (!_s.empty() && _s[0] != '0'))
+	{
+		if (decimalToU256(_s.data(), _s.size(), value))
+			return value;
+	}
+	return u256(_s);
 }
 
 /*bytes dev::asNibbles(bytesConstRef const& _s)
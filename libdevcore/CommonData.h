@@ -74,6 +74,20 @@ template <class T> std::string toHexPrefixed(T const& _data)
 	return toHex(_data.begin(), _data.end(), "0x");
 }
 
+/// Contiguous bytes are converted with the vectorised hexEncode.
+std::string toHex(bytes const& _data);
+std::string toHex(bytesConstRef _data);
+std::string toHexPrefixed(bytes const& _data);
+std::string toHexPrefixed(bytesConstRef _data);
+
+/// Writes the 2 * @a _size lower case hex digits of @a _data to @a o_hex.
+/// Uses AVX2 or SSSE3 if the processor has them, checked at run time.
+void hexEncode(byte const* _data, size_t _size, char* o_hex);
+
+/// Reads 2 * @a _size hex digits of @a _hex into @a o_data.
+/// @returns false if there is a non hex character.
+bool hexDecode(char const* _hex, size_t _size, byte* o_data);
+
 /// Converts a (printable) ASCII hex string into the corresponding byte stream.
 /// @example fromHex("41626261") == asBytes("Abba")
 /// If _throw = ThrowType::DontThrow, it replaces bad hex characters with 0's, otherwise it will throw an exception.
@@ -179,15 +193,24 @@ inline std::string toCompactBigEndianString(T _val, unsigned _min = 0)
 	return ret;
 }
 
-inline std::string toCompactHex(u256 _val, unsigned _min = 0)
-{
-	return toHex(toCompactBigEndian(_val, _min));
-}
+/// Same as toHex(toCompactBigEndian(_val, _min)), without the byte array.
+std::string toCompactHex(u256 const& _val, unsigned _min = 0);
 
-inline std::string toCompactHexPrefixed(u256 _val, unsigned _min = 0)
-{
-	return toHexPrefixed(toCompactBigEndian(_val, _min));
-}
+/// Same as toHexPrefixed(toCompactBigEndian(_val, _min)), without the byte array.
+std::string toCompactHexPrefixed(u256 const& _val, unsigned _min = 0);
+
+/// Reads @a _size hex digits without a prefix into @a o_value.
+/// @returns false if there is a non hex character or there are more than 64 digits.
+bool hexToU256(char const* _hex, size_t _size, u256& o_value);
+
+/// Reads @a _size decimal digits into @a o_value.
+/// @returns false if there is a non decimal character or there are more than 77 digits.
+bool decimalToU256(char const* _digits, size_t _size, u256& o_value);
+
+/// Converts a 0x prefixed hex or a decimal string like u256(_s) does. Plain numbers are read
+/// by hexToU256 and decimalToU256, anything else goes to the boost string parser.
+/// @example toU256("0x0a") == toU256("10")
+u256 toU256(std::string const& _s);
 
 // Algorithms for string and string-like collections.
 
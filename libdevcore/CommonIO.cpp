@@ -126,10 +126,20 @@ void writeFile(boost::filesystem::path const& _file, bytesConstRef _data, bool _
 {
 	if (_writeDeleteRename)
 	{
-		fs::path tempPath = appendToFilename(_file, "-%%%%%%"); // XXX should not convert to string for this
-		writeFile(tempPath, _data, false);
-		// will delete _file if it exists
-		fs::rename(tempPath, _file);
+		// Every writer gets its own temp file, so concurrent writers never share a partial file
+		fs::path tempPath = fs::unique_path(_file.string() + "-%%%%%%");
+		try
+		{
+			writeFile(tempPath, _data, false);
+			// will delete _file if it exists
+			fs::rename(tempPath, _file);
+		}
+		catch (...)
+		{
+			boost::system::error_code ec;
+			fs::remove(tempPath, ec);
+			throw;
+		}
 	}
 	else
 	{
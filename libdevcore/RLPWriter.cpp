@@ -0,0 +1,150 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RLPWriter.cpp
+ */
+
+#include "RLPWriter.h"
+using namespace std;
+using namespace dev;
+
+size_t RLPWriter::headerSize(size_t _payloadSize)
+{
+	// the short forms of data and lists hold the same sizes
+	static_assert(c_rlpDataImmLenCount == c_rlpListImmLenCount, "RLP short form sizes differ");
+	return _payloadSize < c_rlpDataImmLenCount ? 1 : 1 + bytesRequired(_payloadSize);
+}
+
+void RLPWriter::writeHeader(size_t _payloadSize, byte _shortBase, byte _longBase)
+{
+	if (_payloadSize < c_rlpDataImmLenCount)
+		put((byte)(_shortBase + _payloadSize));
+	else
+	{
+		unsigned const br = bytesRequired(_payloadSize);
+		put((byte)(_longBase + br));
+		for (unsigned i = br; i > 0; i--)
+			put((byte)(_payloadSize >> (8 * (i - 1))));
+	}
+}
+
+void RLPWriter::put(byte const* _data, size_t _size)
+{
+	if (m_size - m_written < _size)
+		throwOverflow();
+	m_written += _size;
+	if (m_pass == Pass::WriteHex)
+	{
+		hexEncode(_data, _size, m_hexOut);
+		m_hexOut += 2 * _size;
+	}
+	else if (_size)
+	{
+		memcpy(m_out, _data, _size);
+		m_out += _size;
+	}
+}
+
+void RLPWriter::throwOverflow()
+{
+	BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("RLPWriter: more data written than measured"));
+}
+
+RLPWriter& RLPWriter::appendList()
+{
+	if (m_pass == Pass::Measure)
+	{
+		// the start of the payload is kept until endList() knows its size
+		m_openLists.push_back(m_listPayloads.size());
+		m_listPayloads.push_back(m_size);
+	}
+	else
+	{
+		if (m_nextList >= m_listPayloads.size())
+			throwOverflow();
+		writeHeader(m_listPayloads[m_nextList++], c_rlpListStart, c_rlpListIndLenZero);
+	}
+	return *this;
+}
+
+RLPWriter& RLPWriter::endList()
+{
+	if (m_pass == Pass::Measure)
+	{
+		if (m_openLists.empty())
+			BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("RLPWriter: no list to end"));
+		size_t& payload = m_listPayloads[m_openLists.back()];
+		m_openLists.pop_back();
+		payload = m_size - payload;
+		m_size += headerSize(payload);
+	}
+	return *this;
+}
+
+RLPWriter& RLPWriter::append(bytesConstRef _s)
+{
+	size_t const s = _s.size();
+	if (s == 1 && _s[0] < c_rlpDataImmLenStart)
+	{
+		if (m_pass == Pass::Measure)
+			m_size++;
+		else
+			put(_s[0]);
+	}
+	else if (m_pass == Pass::Measure)
+		m_size += headerSize(s) + s;
+	else
+	{
+		writeHeader(s, c_rlpDataImmLenStart, c_rlpDataIndLenZero);
+		put(_s.data(), s);
+	}
+	return *this;
+}
+
+RLPWriter& RLPWriter::append(u256 const& _i)
+{
+	if (!_i)
+		return append(bytesConstRef());
+	// big endian without the leading zero bytes
+	h256 const value(_i);
+	size_t start = 0;
+	while (!value[start])
+		start++;
+	return append(bytesConstRef(value.data() + start, h256::size - start));
+}
+
+void RLPWriter::startWriting(byte* _out)
+{
+	if (!m_openLists.empty())
+		BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("RLPWriter: list is not ended"));
+	m_pass = Pass::Write;
+	m_out = _out;
+	m_written = 0;
+	m_nextList = 0;
+}
+
+void RLPWriter::startWritingHex(char* _out)
+{
+	startWriting(nullptr);
+	m_pass = Pass::WriteHex;
+	m_hexOut = _out;
+}
+
+void RLPWriter::finishWriting() const
+{
+	if (m_written != m_size || m_nextList != m_listPayloads.size())
+		BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("RLPWriter: written data differs from the measured"));
+}
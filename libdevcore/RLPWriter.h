@@ -0,0 +1,153 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file RLPWriter.h
+ *
+ * RLP serialisation into a preallocated buffer.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Common.h"
+#include "FixedHash.h"
+#include "RLP.h"
+
+namespace dev
+{
+
+/**
+ * @brief RLP encoder that writes into a buffer of the exact size.
+ *
+ * The items are appended twice. The first pass only measures the encoding and the payload of
+ * every list, the second pass writes the bytes, or their hex digits, into the caller's buffer.
+ * Unlike RLPStream nothing is moved when a list is closed and no intermediate vector is made.
+ * Use rlpEncode, rlpEncodeInto or rlpEncodeHexPrefixed to run both passes:
+ * @code
+ * std::string hex = rlpEncodeHexPrefixed([&](RLPWriter& _w) {
+ *     _w.appendList();
+ *     _w << nonce << data;
+ *     _w.endList();
+ * });
+ * @endcode
+ */
+class RLPWriter
+{
+public:
+	/// Starts the measuring pass.
+	RLPWriter() {}
+
+	/// Opens a list. The items appended up to the matching endList() are its elements.
+	RLPWriter& appendList();
+	RLPWriter& endList();
+
+	RLPWriter& append(u256 const& _i);
+	RLPWriter& append(bytesConstRef _s);
+	RLPWriter& append(bytes const& _s) { return append(bytesConstRef(&_s)); }
+	RLPWriter& append(std::string const& _s) { return append(bytesConstRef(_s)); }
+	RLPWriter& append(char const* _s) { return append(bytesConstRef((byte const*)_s, strlen(_s))); }
+	template <unsigned N> RLPWriter& append(FixedHash<N> const& _s) { return append(_s.ref()); }
+
+	/// The RLPStream operators for integers append bigints, which are numbers here as well.
+	RLPWriter& append(unsigned _i) { return append(u256(_i)); }
+	RLPWriter& append(byte _i) { return append(u256(_i)); }
+
+	template <class T> RLPWriter& operator<<(T const& _data) { return append(_data); }
+
+	/// Size of the encoding in bytes, known after the measuring pass.
+	size_t size() const { return m_size; }
+
+	/// Starts the writing pass. The same items have to be appended again, their encoding
+	/// goes to @a _out which must hold size() bytes.
+	void startWriting(byte* _out);
+	/// Same as startWriting, but the encoding is written as 2 * size() hex digits.
+	void startWritingHex(char* _out);
+
+	/// Checks that the writing pass has written the measured encoding.
+	void finishWriting() const;
+
+private:
+	enum class Pass { Measure, Write, WriteHex };
+
+	static size_t headerSize(size_t _payloadSize);
+	void writeHeader(size_t _payloadSize, byte _shortBase, byte _longBase);
+	void put(byte _b)
+	{
+		static char const* c_hexDigits = "0123456789abcdef";
+		if (m_written++ == m_size)
+			throwOverflow();
+		if (m_pass == Pass::WriteHex)
+		{
+			*m_hexOut++ = c_hexDigits[_b >> 4];
+			*m_hexOut++ = c_hexDigits[_b & 0x0f];
+		}
+		else
+			*m_out++ = _b;
+	}
+	void put(byte const* _data, size_t _size);
+	[[noreturn]] static void throwOverflow();
+
+	Pass m_pass = Pass::Measure;
+	size_t m_size = 0;
+	std::vector<size_t> m_listPayloads;  ///< payload size of every list, in the order of appendList
+	std::vector<size_t> m_openLists;     ///< measuring: positions in m_listPayloads of the open lists
+	size_t m_nextList = 0;               ///< writing: the next list in m_listPayloads
+	size_t m_written = 0;                ///< writing: bytes written so far
+	byte* m_out = nullptr;
+	char* m_hexOut = nullptr;
+};
+
+/// Encodes the items that @a _items appends to the writer. @a _items is called twice.
+template <class F> bytes rlpEncode(F const& _items)
+{
+	RLPWriter w;
+	_items(w);
+	bytes out(w.size());
+	w.startWriting(out.data());
+	_items(w);
+	w.finishWriting();
+	return out;
+}
+
+/// Encodes into @a o_buffer, which keeps its capacity between the calls.
+/// @returns the size of the encoding.
+template <class F> size_t rlpEncodeInto(F const& _items, bytes& o_buffer)
+{
+	RLPWriter w;
+	_items(w);
+	o_buffer.resize(w.size());
+	w.startWriting(o_buffer.data());
+	_items(w);
+	w.finishWriting();
+	return w.size();
+}
+
+/// Encodes straight into a 0x prefixed hex string.
+template <class F> std::string rlpEncodeHexPrefixed(F const& _items)
+{
+	RLPWriter w;
+	_items(w);
+	std::string out(w.size() * 2 + 2, '0');
+	out[1] = 'x';
+	w.startWritingHex(&out[2]);
+	_items(w);
+	w.finishWriting();
+	return out;
+}
+
+}
@@ -20,10 +20,15 @@
  */
 
 #include "SHA3.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <numeric>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
 #include "RLP.h"
 using namespace std;
 using namespace dev;
@@ -210,6 +215,228 @@ defsha3(512)
 
 }
 
+namespace
+{
+
+/******** Several Keccak-f[1600] permutations in parallel ********/
+
+/// SHA3-256 absorbs 136 bytes, 17 words, per permutation
+size_t const c_rate = 136;
+
+/// Number of permutations an input of @a _size bytes takes
+size_t blockCount(size_t _size)
+{
+	return _size / c_rate + 1;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEV_KECCAK_SIMD 1
+
+// The states of the lanes are kept word by word: word w of lane j is _states[w * lanes + j].
+// The permutations are compiled for their instruction sets and are only called when the
+// processor has them.
+
+__attribute__((target("avx2")))
+inline __m256i rolAVX2(__m256i _x, int _s)
+{
+	return _mm256_or_si256(_mm256_slli_epi64(_x, _s), _mm256_srli_epi64(_x, 64 - _s));
+}
+
+/// Keccak-f[1600] of 4 states, unrolled like keccakf
+__attribute__((target("avx2")))
+void keccakfAVX2(uint64_t* _states)
+{
+	__m256i a[25];
+	__m256i b[5];
+	__m256i t;
+	uint8_t x, y;
+	for (x = 0; x < 25; x++)
+		a[x] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_states + 4 * x));
+
+	for (int i = 0; i < 24; i++)
+	{
+		// Theta
+		FOR5(x, 1,
+			 b[x] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+				 _mm256_xor_si256(a[x + 10], a[x + 15])), a[x + 20]);)
+		FOR5(x, 1,
+			 t = _mm256_xor_si256(b[(x + 4) % 5], rolAVX2(b[(x + 1) % 5], 1));
+			 FOR5(y, 5,
+				  a[y + x] = _mm256_xor_si256(a[y + x], t); ))
+		// Rho and pi
+		t = a[1];
+		x = 0;
+		REPEAT24(b[0] = a[keccak::pi[x]];
+				 a[keccak::pi[x]] = rolAVX2(t, keccak::rho[x]);
+				 t = b[0];
+				 x++; )
+		// Chi
+		FOR5(y, 5,
+			 FOR5(x, 1,
+				  b[x] = a[y + x];)
+			 FOR5(x, 1,
+				  a[y + x] = _mm256_xor_si256(b[x], _mm256_andnot_si256(b[(x + 1) % 5], b[(x + 2) % 5])); ))
+		// Iota
+		a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(keccak::RC[i]));
+	}
+
+	for (x = 0; x < 25; x++)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(_states + 4 * x), a[x]);
+}
+
+/// Keccak-f[1600] of 8 states, unrolled like keccakf
+__attribute__((target("avx512f")))
+void keccakfAVX512(uint64_t* _states)
+{
+	__m512i a[25];
+	__m512i b[5];
+	__m512i t;
+	uint8_t x, y;
+	for (x = 0; x < 25; x++)
+		a[x] = _mm512_loadu_si512(_states + 8 * x);
+
+	for (int i = 0; i < 24; i++)
+	{
+		// Theta, 0x96 is the xor of three
+		FOR5(x, 1,
+			 b[x] = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a[x], a[x + 5], a[x + 10], 0x96),
+				 a[x + 15], a[x + 20], 0x96);)
+		FOR5(x, 1,
+			 t = _mm512_xor_si512(b[(x + 4) % 5], _mm512_rol_epi64(b[(x + 1) % 5], 1));
+			 FOR5(y, 5,
+				  a[y + x] = _mm512_xor_si512(a[y + x], t); ))
+		// Rho and pi
+		t = a[1];
+		x = 0;
+		REPEAT24(b[0] = a[keccak::pi[x]];
+				 a[keccak::pi[x]] = _mm512_rolv_epi64(t, _mm512_set1_epi64(keccak::rho[x]));
+				 t = b[0];
+				 x++; )
+		// Chi, 0xD2 is b0 ^ (~b1 & b2)
+		FOR5(y, 5,
+			 FOR5(x, 1,
+				  b[x] = a[y + x];)
+			 FOR5(x, 1,
+				  a[y + x] = _mm512_ternarylogic_epi64(b[x], b[(x + 1) % 5], b[(x + 2) % 5], 0xD2); ))
+		// Iota
+		a[0] = _mm512_xor_si512(a[0], _mm512_set1_epi64(keccak::RC[i]));
+	}
+
+	for (x = 0; x < 25; x++)
+		_mm512_storeu_si512(_states + 8 * x, a[x]);
+}
+
+/// Hashes @a _count <= @a Lanes inputs of the same block count with one permutation per block.
+/// The missing lanes repeat the last input.
+template <size_t Lanes, void (*Permute)(uint64_t*)>
+void sha3Lanes(bytesConstRef const* const* _inputs, size_t _count, h256* const* o_outputs)
+{
+	uint64_t states[25 * Lanes] = {};
+	size_t const blocks = blockCount(_inputs[0]->size());
+	for (size_t block = 0; block < blocks; block++)
+	{
+		for (size_t j = 0; j < Lanes; j++)
+		{
+			bytesConstRef const& input = *_inputs[std::min(j, _count - 1)];
+			byte const* data = input.data() + block * c_rate;
+			// the last block takes the rest of the input and the padding
+			byte last[c_rate];
+			if (block + 1 == blocks)
+			{
+				size_t const rest = input.size() - block * c_rate;
+				if (rest)
+					memcpy(last, data, rest);
+				memset(last + rest, 0, c_rate - rest);
+				last[rest] ^= 0x01;
+				last[c_rate - 1] ^= 0x80;
+				data = last;
+			}
+			// the words are little endian, as everywhere the permutations are compiled
+			for (size_t w = 0; w < c_rate / 8; w++)
+			{
+				uint64_t word;
+				memcpy(&word, data + 8 * w, 8);
+				states[w * Lanes + j] ^= word;
+			}
+		}
+		Permute(states);
+	}
+	for (size_t j = 0; j < _count; j++)
+		for (size_t w = 0; w < 4; w++)
+			memcpy(o_outputs[j]->data() + 8 * w, &states[w * Lanes + j], 8);
+}
+#endif
+
+struct Sha3BatchImplementation
+{
+	Sha3BatchImplementation()
+	{
+#if defined(DEV_KECCAK_SIMD)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+		{
+			lanes = 8;
+			hashLanes = sha3Lanes<8, keccakfAVX512>;
+		}
+		else if (__builtin_cpu_supports("avx2"))
+		{
+			lanes = 4;
+			hashLanes = sha3Lanes<4, keccakfAVX2>;
+		}
+#endif
+	}
+	/// Inputs hashed at once, 1 if there is no parallel permutation
+	size_t lanes = 1;
+	void (*hashLanes)(bytesConstRef const* const*, size_t, h256* const*) = nullptr;
+};
+
+Sha3BatchImplementation const& sha3BatchImplementation()
+{
+	static Sha3BatchImplementation const implementation;
+	return implementation;
+}
+
+}
+
+void sha3Batch(bytesConstRef const* _inputs, size_t _count, h256* o_outputs)
+{
+	Sha3BatchImplementation const& implementation = sha3BatchImplementation();
+	size_t const lanes = implementation.lanes;
+	if (lanes == 1)
+	{
+		for (size_t i = 0; i < _count; i++)
+			o_outputs[i] = sha3(_inputs[i]);
+		return;
+	}
+
+	// The lanes of a permutation have to absorb the same number of blocks
+	std::vector<size_t> order(_count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t _a, size_t _b) {
+		return blockCount(_inputs[_a].size()) < blockCount(_inputs[_b].size());
+	});
+
+	std::vector<bytesConstRef const*> inputs(lanes);
+	std::vector<h256*> outputs(lanes);
+	for (size_t begin = 0; begin < _count;)
+	{
+		size_t const blocks = blockCount(_inputs[order[begin]].size());
+		size_t count = 0;
+		while (count < lanes && begin + count < _count &&
+			   blockCount(_inputs[order[begin + count]].size()) == blocks)
+		{
+			inputs[count] = &_inputs[order[begin + count]];
+			outputs[count] = &o_outputs[order[begin + count]];
+			count++;
+		}
+		if (count == 1)
+			*outputs[0] = sha3(*inputs[0]);
+		else
+			implementation.hashLanes(inputs.data(), count, outputs.data());
+		begin += count;
+	}
+}
+
 bool sha3(bytesConstRef _input, bytesRef o_output)
 {
 	// FIXME: What with unaligned memory?
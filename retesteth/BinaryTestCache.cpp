@@ -0,0 +1,348 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Parsed test files kept on disk in binary form between runs
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <libdevcore/CommonIO.h>
+#include <retesteth/BinaryTestCache.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+using namespace dev;
+namespace fs = boost::filesystem;
+
+namespace
+{
+using namespace test;
+
+char const c_magic[] = {'R', 'T', 'B', 'C'};
+uint64_t const c_version = 1;  ///< Increase when the format changes, old entries are rebuilt
+size_t const c_maxDepth = 1000;
+
+void writeVarint(string& _out, uint64_t _value)
+{
+    while (_value >= 0x80)
+    {
+        _out += char(_value | 0x80);
+        _value >>= 7;
+    }
+    _out += char(_value);
+}
+
+void collectKeys(DataObject const& _data, unordered_map<string, uint64_t>& _keys, string& _out)
+{
+    string const& key = _data.getKey();
+    if (!key.empty() && _keys.emplace(key, _keys.size() + 1).second)
+    {
+        writeVarint(_out, key.size());
+        _out += key;
+    }
+    for (auto const& obj : _data.getSubObjects())
+        collectKeys(obj, _keys, _out);
+}
+
+void writeNode(DataObject const& _data, unordered_map<string, uint64_t> const& _keys, string& _out)
+{
+    _out += char(_data.type());
+    writeVarint(_out, _data.getKey().empty() ? 0 : _keys.at(_data.getKey()));
+    switch (_data.type())
+    {
+    case DataType::String:
+        writeVarint(_out, _data.asString().size());
+        _out += _data.asString();
+        break;
+    case DataType::Integer:
+    {
+        // zigzag, so small negative numbers stay short
+        int64_t const value = _data.asInt();
+        writeVarint(_out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+        break;
+    }
+    case DataType::Bool:
+        _out += char(_data.asBool() ? 1 : 0);
+        break;
+    case DataType::Array:
+    case DataType::Object:
+        writeVarint(_out, _data.getSubObjects().size());
+        for (auto const& obj : _data.getSubObjects())
+            writeNode(obj, _keys, _out);
+        break;
+    default:
+        break;
+    }
+}
+
+class BinaryReader
+{
+public:
+    BinaryReader(char const* _data, size_t _size) : m_pos(_data), m_end(_data + _size) {}
+
+    bool readVarint(uint64_t& _value)
+    {
+        _value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (m_pos == m_end)
+                return false;
+            unsigned char const b = *m_pos++;
+            _value |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool readBytes(uint64_t _size, char const*& _bytes)
+    {
+        if (uint64_t(m_end - m_pos) < _size)
+            return false;
+        _bytes = m_pos;
+        m_pos += _size;
+        return true;
+    }
+
+    char const* position() const { return m_pos; }
+
+    bool readData(DataObject& _out)
+    {
+        uint64_t keyCount;
+        if (!readVarint(keyCount) || keyCount > uint64_t(m_end - m_pos))
+            return false;
+        m_keys.reserve(keyCount);
+        for (uint64_t i = 0; i < keyCount; i++)
+        {
+            uint64_t size;
+            char const* bytes;
+            if (!readVarint(size) || !readBytes(size, bytes))
+                return false;
+            m_keys.emplace_back(bytes, size);
+        }
+        return readNode(_out, 0) && m_pos == m_end;
+    }
+
+private:
+    bool readNode(DataObject& _out, size_t _depth)
+    {
+        if (_depth > c_maxDepth || m_pos == m_end)
+            return false;
+        unsigned char const type = *m_pos++;
+        uint64_t keyIndex;
+        if (!readVarint(keyIndex) || keyIndex > m_keys.size())
+            return false;
+
+        switch (type)
+        {
+        case DataType::Null:
+            break;
+        case DataType::String:
+        {
+            uint64_t size;
+            char const* bytes;
+            if (!readVarint(size) || !readBytes(size, bytes))
+                return false;
+            _out = string(bytes, size);
+            break;
+        }
+        case DataType::Integer:
+        {
+            uint64_t value;
+            if (!readVarint(value))
+                return false;
+            _out = int(int64_t(value >> 1) ^ -int64_t(value & 1));
+            break;
+        }
+        case DataType::Bool:
+        {
+            char const* value;
+            if (!readBytes(1, value))
+                return false;
+            _out = DataObject(DataType::Bool, *value != 0);
+            break;
+        }
+        case DataType::Array:
+        case DataType::Object:
+        {
+            uint64_t count;
+            // every node takes at least two bytes
+            if (!readVarint(count) || count > uint64_t(m_end - m_pos) / 2)
+                return false;
+            vector<DataObject> children(count);
+            for (auto& child : children)
+                if (!readNode(child, _depth + 1))
+                    return false;
+            _out = DataObject(DataType(type));
+            _out.getSubObjectsUnsafe().swap(children);
+            break;
+        }
+        default:
+            return false;
+        }
+
+        if (keyIndex)
+            _out.setKey(m_keys[keyIndex - 1]);
+        return true;
+    }
+
+    char const* m_pos;
+    char const* const m_end;
+    vector<string> m_keys;
+};
+
+/// Size and modification time of the source the entry was made from
+bool sourceStamp(fs::path const& _source, uint64_t& _size, uint64_t& _mtime)
+{
+    boost::system::error_code error;
+    _size = fs::file_size(_source, error);
+    if (error)
+        return false;
+    _mtime = uint64_t(fs::last_write_time(_source, error));
+    return !error;
+}
+}  // namespace
+
+namespace test
+{
+void writeBinaryData(DataObject const& _data, string& _out)
+{
+    unordered_map<string, uint64_t> keys;
+    string keyTable;
+    collectKeys(_data, keys, keyTable);
+    writeVarint(_out, keys.size());
+    _out += keyTable;
+    writeNode(_data, keys, _out);
+}
+
+bool readBinaryData(char const* _data, size_t _size, DataObject& _out)
+{
+    DataObject data;
+    if (!BinaryReader(_data, _size).readData(data))
+        return false;
+    _out.replace(std::move(data));
+    return true;
+}
+
+BinaryTestCache& BinaryTestCache::get()
+{
+    static BinaryTestCache instance;
+    return instance;
+}
+
+BinaryTestCache::BinaryTestCache() : m_enabled(Options::get().binaryCache)
+{
+    fs::path const testPath = fs::absolute(getTestPath());
+    m_testPath = testPath.string();
+    if (!m_testPath.empty() && m_testPath.back() != '/')
+        m_testPath += '/';
+    m_cachePath = testPath / "Retesteth" / "binaryCache";
+}
+
+fs::path BinaryTestCache::entryPath(fs::path const& _source) const
+{
+    string const source = fs::absolute(_source).string();
+    if (source.size() <= m_testPath.size() || source.compare(0, m_testPath.size(), m_testPath) != 0)
+        return fs::path();
+    return m_cachePath / (source.substr(m_testPath.size()) + ".bin");
+}
+
+bool BinaryTestCache::load(fs::path const& _source, DataObject& _data, h256& _hash) const
+{
+    if (!m_enabled)
+        return false;
+    fs::path const entry = entryPath(_source);
+    uint64_t sourceSize;
+    uint64_t sourceMtime;
+    if (entry.empty() || !sourceStamp(_source, sourceSize, sourceMtime))
+        return false;
+
+    int const fd = open(entry.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool result = false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        // The pages are read on access while the tree is built, no copy of the file is made
+        void* const map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            char const* const data = static_cast<char const*>(map);
+            size_t const size = st.st_size;
+            size_t const headerSize = sizeof(c_magic);
+            BinaryReader header(data + headerSize, size - min(size, headerSize));
+            uint64_t version;
+            uint64_t entrySourceSize;
+            uint64_t mtime;
+            char const* hash;
+            if (size > headerSize && memcmp(data, c_magic, headerSize) == 0 &&
+                header.readVarint(version) && version == c_version &&
+                header.readVarint(entrySourceSize) && entrySourceSize == sourceSize &&
+                header.readVarint(mtime) && mtime == sourceMtime &&
+                header.readBytes(h256::size, hash))
+            {
+                char const* const payload = header.position();
+                if (readBinaryData(payload, data + size - payload, _data))
+                {
+                    _hash = h256(reinterpret_cast<byte const*>(hash), h256::ConstructFromPointer);
+                    result = true;
+                }
+            }
+            munmap(map, st.st_size);
+        }
+    }
+    close(fd);
+    return result;
+}
+
+void BinaryTestCache::store(fs::path const& _source, DataObject const& _data, h256 const& _hash) const
+{
+    if (!m_enabled)
+        return;
+    fs::path const entry = entryPath(_source);
+    uint64_t sourceSize;
+    uint64_t sourceMtime;
+    if (entry.empty() || !sourceStamp(_source, sourceSize, sourceMtime))
+        return;
+
+    string out(c_magic, sizeof(c_magic));
+    writeVarint(out, c_version);
+    writeVarint(out, sourceSize);
+    writeVarint(out, sourceMtime);
+    out.append(reinterpret_cast<char const*>(_hash.data()), h256::size);
+    writeBinaryData(_data, out);
+
+    // Written next to the entry and renamed, so a concurrent run never reads a partial file
+    try
+    {
+        writeFile(entry, bytesConstRef(reinterpret_cast<byte const*>(out.data()), out.size()), true);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_TEST_MESSAGE("Could not save binary cache of " + _source.string() + ": " + _ex.what());
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,64 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Parsed test files kept on disk in binary form between runs
+ */
+
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <retesteth/DataObject.h>
+#include <boost/filesystem/path.hpp>
+#include <string>
+
+namespace test
+{
+/// Compact binary form of DataObject. Every distinct key is written once into a table in front
+/// of the tree, the nodes refer to the keys by index.
+void writeBinaryData(DataObject const& _data, std::string& _out);
+
+/// Read the binary form written by writeBinaryData. Returns false if _data is malformed
+bool readBinaryData(char const* _data, size_t _size, DataObject& _out);
+
+/// Parsed test files and fillers are kept in <testpath>/Retesteth/binaryCache with the same
+/// relative path as the source file. An entry is used while the size and modification time of
+/// the source match the ones recorded in the entry, so unchanged files are not parsed again.
+class BinaryTestCache
+{
+public:
+    static BinaryTestCache& get();
+
+    /// Load the parsed _source from the cache. _hash is the filler hash stored with the entry.
+    /// Returns false if there is no valid entry for the current version of _source.
+    bool load(boost::filesystem::path const& _source, DataObject& _data, dev::h256& _hash) const;
+
+    /// Save the parsed _source. Errors are ignored, the cache is optional
+    void store(boost::filesystem::path const& _source, DataObject const& _data,
+        dev::h256 const& _hash = dev::h256()) const;
+
+private:
+    BinaryTestCache();
+    BinaryTestCache(BinaryTestCache const&) = delete;
+
+    /// Path of the cache entry, empty if _source is outside of the test path
+    boost::filesystem::path entryPath(boost::filesystem::path const& _source) const;
+
+    bool m_enabled;
+    std::string m_testPath;
+    boost::filesystem::path m_cachePath;
+};
+
+}  // namespace test
@@ -1,21 +1,73 @@
 #include <retesteth/DataObject.h>
+#include <algorithm>
 using namespace  test;
 
+struct DataObject::ValueCache
+{
+	std::atomic<dev::u256*> number{nullptr};
+	std::atomic<dev::bytes*> data{nullptr};
+	std::atomic<dev::h256*> hash{nullptr};
+	std::atomic<dev::Address*> address{nullptr};
+	~ValueCache()
+	{
+		delete number.load();
+		delete data.load();
+		delete hash.load();
+		delete address.load();
+	}
+};
+
+namespace
+{
+/// Objects with less keys are searched linearly
+size_t const c_keyIndexThreshold = 16;
+
+/// Build the view on first use. Concurrent readers could build it at the same time, only one
+/// is kept
+template <class T, class Make>
+T const& cachedView(std::atomic<T*>& _view, Make _make)
+{
+	T* value = _view.load();
+	if (!value)
+	{
+		std::unique_ptr<T> newValue(new T(_make()));
+		T* expected = nullptr;
+		if (_view.compare_exchange_strong(expected, newValue.get()))
+			value = newValue.release();
+		else
+			value = expected;
+	}
+	return *value;
+}
+
+void writeIndent(std::ostream& _out, int _level)
+{
+	static char const c_spaces[] = "                                ";
+	size_t count = _level * 4;
+	while (count > 0)
+	{
+		size_t const chunk = std::min(count, sizeof(c_spaces) - 1);
+		_out.write(c_spaces, chunk);
+		count -= chunk;
+	}
+}
+}
+
 /// Default dataobject is null
-DataObject::DataObject() {	m_type = DataType::Null; }
+DataObject::DataObject() : m_keyIndex(nullptr), m_valueCache(nullptr) {	m_type = DataType::Null; }
 
 /// Define dataobject of _type, pass the value later (will check the value and _type)
-DataObject::DataObject(DataType _type) { m_type = _type; }
+DataObject::DataObject(DataType _type) : m_keyIndex(nullptr), m_valueCache(nullptr) { m_type = _type; }
 
 /// Define dataobject of string
-DataObject::DataObject(std::string const& _str)
+DataObject::DataObject(std::string const& _str) : m_keyIndex(nullptr), m_valueCache(nullptr)
 {
 	m_type = DataType::String;
 	m_strVal = _str;
 }
 
 /// Define dataobject[_key] = string
-DataObject::DataObject(std::string const& _key, std::string const& _str)
+DataObject::DataObject(std::string const& _key, std::string const& _str) : m_keyIndex(nullptr), m_valueCache(nullptr)
 {
 	m_type = DataType::String;
 	m_strVal = _str;
@@ -23,19 +75,49 @@ DataObject::DataObject(std::string const& _key, std::string const& _str)
 }
 
 /// Define dataobject of int
-DataObject::DataObject(int _int)
+DataObject::DataObject(int _int) : m_keyIndex(nullptr), m_valueCache(nullptr)
 {
 	m_type = DataType::Integer;
 	m_intVal = _int;
 }
 
 /// Define dataobject of bool
-DataObject::DataObject(DataType type, bool _bool)
+DataObject::DataObject(DataType type, bool _bool) : m_keyIndex(nullptr), m_valueCache(nullptr)
 {
     m_type = type;
     m_boolVal = _bool;
 }
 
+/// Copy dataobject. The key index and typed views are not copied, the copy builds its own
+DataObject::DataObject(DataObject const& _other)
+  : m_subObjects(_other.m_subObjects),
+    m_type(_other.m_type),
+    m_strKey(_other.m_strKey),
+    m_strVal(_other.m_strVal),
+    m_boolVal(_other.m_boolVal),
+    m_intVal(_other.m_intVal),
+    m_keyIndex(nullptr),
+    m_valueCache(nullptr)
+{}
+
+/// Move dataobject. The key index stays valid as the subobjects keep their positions
+DataObject::DataObject(DataObject&& _other) noexcept
+  : m_subObjects(std::move(_other.m_subObjects)),
+    m_type(_other.m_type),
+    m_strKey(std::move(_other.m_strKey)),
+    m_strVal(std::move(_other.m_strVal)),
+    m_boolVal(_other.m_boolVal),
+    m_intVal(_other.m_intVal),
+    m_keyIndex(_other.m_keyIndex.exchange(nullptr)),
+    m_valueCache(_other.m_valueCache.exchange(nullptr))
+{}
+
+DataObject::~DataObject()
+{
+	delete m_keyIndex.load();
+	delete m_valueCache.load();
+}
+
 /// Get dataobject type
 DataType DataObject::type() const {	return m_type; }
 
@@ -43,21 +125,35 @@ DataType DataObject::type() const {	return m_type; }
 void DataObject::setKey(std::string const& _key) { m_strKey = _key; }
 
 /// Get key of the dataobject
-std::string const& DataObject::getKey() const {	return m_strKey; }
+std::string const& DataObject::getKey() const { return m_strKey; }
 
 /// Get vector of subobjects
 std::vector<DataObject>const& DataObject::getSubObjects() const { return m_subObjects; }
 
-/// Get ref vector of subobjects
-std::vector<DataObject>& DataObject::getSubObjectsUnsafe() { return m_subObjects; }
+/// Get ref vector of subobjects. The caller could change the keys, so the index is dropped
+std::vector<DataObject>& DataObject::getSubObjectsUnsafe()
+{
+	_dropKeyIndex();
+	return m_subObjects;
+}
 
 /// Add new subobject
-void DataObject::addSubObject(DataObject const& _obj) {	_addSubObject(_obj); }
+void DataObject::addSubObject(DataObject const& _obj) {	_addSubObject(DataObject(_obj)); }
+
+/// Add new subobject without copying it
+void DataObject::addSubObject(DataObject&& _obj) { _addSubObject(std::move(_obj)); }
 
 /// Add new subobject and set it's key
 void DataObject::addSubObject(std::string const& _key, DataObject const& _obj)
 {
-	_addSubObject(_obj);
+	_addSubObject(DataObject(_obj));
+	setSubObjectKey(m_subObjects.size() - 1, _key);
+}
+
+/// Add new subobject without copying it and set it's key
+void DataObject::addSubObject(std::string const& _key, DataObject&& _obj)
+{
+	_addSubObject(std::move(_obj));
 	setSubObjectKey(m_subObjects.size() - 1, _key);
 }
 
@@ -66,16 +162,24 @@ void DataObject::setSubObjectKey(size_t _index, std::string const& _key)
 {
 	_assert(_index < m_subObjects.size(), "_index < m_subObjects.size()");
 	if (m_subObjects.size() > _index)
+	{
+		KeyIndex* index = m_keyIndex.load();
+		if (index)
+		{
+			auto const it = index->find(m_subObjects.at(_index).getKey());
+			if (it != index->end() && it->second == _index)
+				index->erase(it);
+			if (!_key.empty())
+				index->emplace(_key, _index);
+		}
 		m_subObjects.at(_index).setKey(_key);
+	}
 }
 
 /// look if there is a subobject with _key
 bool DataObject::count(std::string const& _key) const
 {
-	for (auto const& i: m_subObjects)
-		if (i.getKey() == _key)
-			return true;
-	return false;
+	return _findKey(_key) != npos;
 }
 
 /// Get string value
@@ -99,6 +203,37 @@ bool DataObject::asBool() const
 	return m_boolVal;
 }
 
+/// Get value as u256. Hex and decimal strings are accepted like u256(asString())
+dev::u256 const& DataObject::asU256() const
+{
+	return cachedView(_valueCache().number, [this]() {
+		if (m_type == DataType::Integer)
+		{
+			_assert(m_intVal >= 0, "m_intVal >= 0");
+			return dev::u256(m_intVal);
+		}
+		return dev::toU256(asString());
+	});
+}
+
+/// Get hex string value as bytes
+dev::bytes const& DataObject::asBytes() const
+{
+	return cachedView(_valueCache().data, [this]() { return dev::fromHex(asString()); });
+}
+
+/// Get hex string value as h256
+dev::h256 const& DataObject::asHash() const
+{
+	return cachedView(_valueCache().hash, [this]() { return dev::h256(asString()); });
+}
+
+/// Get hex string value as Address
+dev::Address const& DataObject::asAddress() const
+{
+	return cachedView(_valueCache().address, [this]() { return dev::Address(asString()); });
+}
+
 /// Set position in vector of the subobject with _key
 void DataObject::setKeyPos(std::string const& _key, size_t _pos)
 {
@@ -122,7 +257,7 @@ void DataObject::setKeyPos(std::string const& _key, size_t _pos)
 	{
 		if (i == _pos)
 		{
-			if (i == m_subObjects.size() - 1 || (m_subObjects[i-1].getKey() == _key && i >= 1))
+			if (i == m_subObjects.size() - 1 || (i >= 1 && m_subObjects[i-1].getKey() == _key))
 			{
 				newSubObjects.push_back(m_subObjects[i]);
 				newSubObjects.push_back(this->at(_key));
@@ -135,6 +270,7 @@ void DataObject::setKeyPos(std::string const& _key, size_t _pos)
 	}
 	m_subObjects.clear();
 	m_subObjects = newSubObjects;
+	_dropKeyIndex();
 	_checkDoubleKeys();
 }
 
@@ -142,7 +278,7 @@ void DataObject::setKeyPos(std::string const& _key, size_t _pos)
 /// replace this object with _value
 void DataObject::replace(DataObject const& _value)
 {
-	m_strKey = _value.getKey();
+	m_strKey = _value.m_strKey;
 	switch(_value.type())
 	{
 		case DataType::String:
@@ -161,14 +297,29 @@ void DataObject::replace(DataObject const& _value)
 	m_type = _value.type();
 	m_subObjects.clear();
 	m_subObjects = _value.getSubObjects();
+	_dropKeyIndex();
+	_dropValueCache();
+}
+
+/// replace this object with _value without copying it
+void DataObject::replace(DataObject&& _value)
+{
+	m_strKey = std::move(_value.m_strKey);
+	m_strVal = std::move(_value.m_strVal);
+	m_intVal = _value.m_intVal;
+	m_boolVal = _value.m_boolVal;
+	m_type = _value.m_type;
+	m_subObjects = std::move(_value.m_subObjects);
+	delete m_keyIndex.exchange(_value.m_keyIndex.exchange(nullptr));
+	_takeValueCache(_value);
 }
 
 DataObject const& DataObject::at(std::string const& _key) const
 {
-	_assert(count(_key), "count(_key) _key=" + _key);
-	for (auto const& i: m_subObjects)
-		if (i.getKey() == _key)
-			return i;
+	size_t const pos = _findKey(_key);
+	_assert(pos != npos, "count(_key) _key=" + _key);
+	if (pos != npos)
+		return m_subObjects[pos];
 	return m_subObjects[0]; // should never hit this line
 }
 
@@ -179,24 +330,29 @@ void DataObject::addArrayObject(DataObject const& _obj)
 	m_subObjects.push_back(_obj);
 }
 
+void DataObject::addArrayObject(DataObject&& _obj)
+{
+	_assert(m_type == DataType::Null || m_type == DataType::Array, "m_type == DataType::Null || m_type == DataType::Array");
+	m_type = DataType::Array;
+	m_subObjects.push_back(std::move(_obj));
+}
+
 void DataObject::renameKey(std::string const& _currentKey, std::string const& _newKey)
 {
-	if (m_strKey == _currentKey)
-		m_strKey = _newKey;
-	for (auto& obj : m_subObjects)
-	{
-		if (!obj.getKey().empty() && obj.getKey() == _currentKey)
-		{
-			obj.setKey(_newKey);
-			break;
-		}
-	}
+	if (getKey() == _currentKey)
+		setKey(_newKey);
+	if (_currentKey.empty())
+		return;
+	size_t const pos = _findKey(_currentKey);
+	if (pos != npos)
+		setSubObjectKey(pos, _newKey);
 }
 
 /// vector<element> erase method with `replace()` function
 void DataObject::removeKey(std::string const& _key)
 {
     _assert(type() == DataType::Object, "type() == DataType::Object");
+    _dropKeyIndex();  // positions after _key are shifted
     bool startReplace = false;
     for (std::vector<DataObject>::iterator it = m_subObjects.begin(); it != m_subObjects.end(); it++)
     {
@@ -221,91 +377,61 @@ void DataObject::clear()
     m_intVal = 0;
     m_subObjects.clear();
     m_type = DataType::Null;
+    _dropKeyIndex();
+    _dropValueCache();
 }
 
 std::string DataObject::asJson(int level, bool pretty) const
 {
 	std::ostringstream out;
-    auto printLevel = [level, pretty, &out]() -> void {
-        if (pretty)
-            for (int i = 0; i < level * 4; i++)
-                out << " ";
-    };
-
-    auto printElements = [this, &out, level, pretty]() -> void {
-		for(std::vector<DataObject>::const_iterator it = this->m_subObjects.begin();
-			it < this->m_subObjects.end(); it++)
-		{
-            out << (*it).asJson(level + 1, pretty);
-            if (it+1 != this->m_subObjects.end())
-				out << ",";
-			out << std::endl;
-		}
-    };
+	asJson(out, level, pretty);
+	return out.str();
+}
+
+/// Write json into _out without building the intermediate strings
+/// Compact mode writes no indentation and no new lines
+void DataObject::asJson(std::ostream& _out, int level, bool pretty) const
+{
+	if (pretty)
+		writeIndent(_out, level);
+	if (!m_strKey.empty())
+		_out << "\"" << m_strKey << (pretty ? "\" : " : "\":");
 
-    switch(m_type)
+	switch(m_type)
 	{
 		case DataType::Null:
-			printLevel();
-			if (!m_strKey.empty())
-				out << "\"" << m_strKey << "\" : ";
-			out << "\"" << "null" << "\"";
+			_out << "\"null\"";
 		break;
 		case DataType::Object:
-			if (!m_strKey.empty())
-			{
-				printLevel();
-				out << "\"" << m_strKey << "\" : {" << std::endl;
-			}
-			else
-			{
-				printLevel();
-				out << "{" << std::endl;
-			}
-			printElements();
-			printLevel();
-			out << "}";
-		break;
 		case DataType::Array:
-			if (!m_strKey.empty())
+			_out.put(m_type == DataType::Object ? '{' : '[');
+			if (pretty)
+				_out.put('\n');
+			for (size_t i = 0; i < m_subObjects.size(); i++)
 			{
-				printLevel();
-				out << "\"" << m_strKey << "\" : [" << std::endl;
+				m_subObjects[i].asJson(_out, level + 1, pretty);
+				if (i + 1 != m_subObjects.size())
+					_out.put(',');
+				if (pretty)
+					_out.put('\n');
 			}
-			else
-			{
-				printLevel();
-				out << "[" << std::endl;
-			}
-			printElements();
-			printLevel();
-			out << "]";
+			if (pretty)
+				writeIndent(_out, level);
+			_out.put(m_type == DataType::Object ? '}' : ']');
 		break;
 		case DataType::String:
-			printLevel();
-			if (!m_strKey.empty())
-				out << "\"" << m_strKey << "\" : ";
-			out << "\"" << m_strVal << "\"";
+			_out << "\"" << m_strVal << "\"";
 		break;
 		case DataType::Integer:
-			printLevel();
-			if (!m_strKey.empty())
-				out << "\"" << m_strKey << "\" : ";
-			out << m_intVal;
+			_out << m_intVal;
 		break;
 		case DataType::Bool:
-			printLevel();
-			if (!m_strKey.empty())
-				out << "\"" << m_strKey << "\" : ";
-            if (m_boolVal)
-                out << "true";
-            out << "false";
-            break;
+			_out << (m_boolVal ? "true" : "false");
+		break;
 		default:
-			out << "unknown " << dataTypeAsString(m_type) << std::endl;
+			_out << "unknown " << dataTypeAsString(m_type) << std::endl;
 		break;
 	}
-	return out.str();
 }
 
 std::string DataObject::dataTypeAsString(DataType _type)
@@ -323,12 +449,80 @@ std::string DataObject::dataTypeAsString(DataType _type)
 	return "";
 }
 
-void DataObject::_addSubObject(DataObject const& _obj)
+void DataObject::_addSubObject(DataObject&& _obj)
 {
 	if (m_type == DataType::Null)
 		m_type = DataType::Object;
-	_checkDoubleKeys();
-	m_subObjects.push_back(_obj);
+	_assert(m_type == DataType::Object, "m_type == DataType::Object");
+	std::string const& key = _obj.getKey();
+	if (!key.empty())
+		_assert(!count(key), "!count(key), double key: '" + key + "' in the object!");
+	m_subObjects.push_back(std::move(_obj));
+	KeyIndex* index = m_keyIndex.load();
+	if (index && !m_subObjects.back().getKey().empty())
+		index->emplace(m_subObjects.back().getKey(), m_subObjects.size() - 1);
+}
+
+size_t DataObject::_findKey(std::string const& _key) const
+{
+	if (m_subObjects.size() < c_keyIndexThreshold)
+	{
+		for (size_t i = 0; i < m_subObjects.size(); i++)
+			if (m_subObjects[i].getKey() == _key)
+				return i;
+		return npos;
+	}
+
+	KeyIndex* index = m_keyIndex.load();
+	if (!index)
+	{
+		// Concurrent readers could build the index at the same time. Only one is kept
+		std::unique_ptr<KeyIndex> newIndex(new KeyIndex());
+		newIndex->reserve(m_subObjects.size());
+		for (size_t i = 0; i < m_subObjects.size(); i++)
+			if (!m_subObjects[i].getKey().empty())
+				newIndex->emplace(m_subObjects[i].getKey(), i);  // keeps the first of double keys
+		KeyIndex* expected = nullptr;
+		if (m_keyIndex.compare_exchange_strong(expected, newIndex.get()))
+			index = newIndex.release();
+		else
+			index = expected;
+	}
+
+	auto const it = index->find(_key);
+	if (it == index->end())
+		return npos;
+	return it->second;
+}
+
+void DataObject::_dropKeyIndex()
+{
+	delete m_keyIndex.exchange(nullptr);
+}
+
+DataObject::ValueCache& DataObject::_valueCache() const
+{
+	ValueCache* cache = m_valueCache.load();
+	if (!cache)
+	{
+		std::unique_ptr<ValueCache> newCache(new ValueCache());
+		ValueCache* expected = nullptr;
+		if (m_valueCache.compare_exchange_strong(expected, newCache.get()))
+			cache = newCache.release();
+		else
+			cache = expected;
+	}
+	return *cache;
+}
+
+void DataObject::_dropValueCache()
+{
+	delete m_valueCache.exchange(nullptr);
+}
+
+void DataObject::_takeValueCache(DataObject& _other)
+{
+	delete m_valueCache.exchange(_other.m_valueCache.exchange(nullptr));
 }
 
 void DataObject::_checkDoubleKeys() const
@@ -349,7 +543,7 @@ void DataObject::_assert(bool _flag, std::string const& _comment) const
 	if (!_flag)
 	{
 		std::cerr << "Error in DataObject: " << std::endl;
-		std::cerr << " key: '" << m_strKey << "'";
+		std::cerr << " key: '" << getKey() << "'";
 		std::cerr << " type: '" << dataTypeAsString(m_type) << "'" << std::endl;
 		std::cerr << " assert: " << _comment << std::endl;
 		assert(_flag);
@@ -1,8 +1,12 @@
 #pragma once
+#include <atomic>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <boost/test/unit_test.hpp>
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/Address.h>
 
 namespace  test {
 enum DataType
@@ -24,13 +28,28 @@ class DataObject
     DataObject(std::string const& _str);
 	DataObject(std::string const& _key, std::string const& _str);
 	DataObject(int _int);
+	DataObject(DataObject const& _other);
+	DataObject(DataObject&& _other) noexcept;
+	~DataObject();
 	DataType type() const;
 	void setKey(std::string const& _key);
 	std::string const& getKey() const;
 	std::vector<DataObject>const& getSubObjects() const;
 	std::vector<DataObject>& getSubObjectsUnsafe();
 	void addSubObject(DataObject const& _obj);
+	void addSubObject(DataObject&& _obj);
 	void addSubObject(std::string const& _key, DataObject const& _obj);
+	void addSubObject(std::string const& _key, DataObject&& _obj);
+
+	/// Construct a subobject with _key in place and return it for filling
+	template <class... Args>
+	DataObject& emplaceSubObject(std::string const& _key, Args&&... _args)
+	{
+		DataObject obj(std::forward<Args>(_args)...);
+		obj.setKey(_key);
+		_addSubObject(std::move(obj));
+		return m_subObjects.back();
+	}
 	void setSubObjectKey(size_t _index, std::string const& _key);
 
 	bool count(std::string const& _key) const;
@@ -38,16 +57,22 @@ class DataObject
     int asInt() const;
 	bool asBool() const;
 
+	/// Typed views of the value. Parsed on first use and cached until the value is changed
+	dev::u256 const& asU256() const;
+	dev::bytes const& asBytes() const;
+	dev::h256 const& asHash() const;
+	dev::Address const& asAddress() const;
+
 	void setKeyPos(std::string const& _key, size_t _pos);
 	DataObject& operator[] (std::string const& _key)
 	{
         _assert(m_type == DataType::Null || m_type == DataType::Object, "m_type == DataType::Null || m_type == DataType::Object");
-		for (auto& i: m_subObjects)
-			if (i.getKey() == _key)
-				return i;
+		size_t const pos = _findKey(_key);
+		if (pos != npos)
+			return m_subObjects[pos];
 		DataObject obj(DataType::Null);
 		obj.setKey(_key);
-		_addSubObject(obj);
+		_addSubObject(std::move(obj));
 		return m_subObjects[m_subObjects.size() - 1];
 	}
 
@@ -56,6 +81,16 @@ class DataObject
 		assert(m_type == DataType::String || m_type == DataType::Null);
 		m_type = DataType::String;
 		m_strVal = _value;
+		_dropValueCache();
+		return *this;
+	}
+
+	DataObject& operator = (std::string&& _value)
+	{
+		assert(m_type == DataType::String || m_type == DataType::Null);
+		m_type = DataType::String;
+		m_strVal = std::move(_value);
+		_dropValueCache();
 		return *this;
 	}
 
@@ -64,6 +99,7 @@ class DataObject
 		assert(m_type == DataType::Integer || m_type == DataType::Null);
 		m_type = DataType::Integer;
 		m_intVal = _value;
+		_dropValueCache();
 		return *this;
 	}
 
@@ -84,14 +120,32 @@ class DataObject
 				break;
 		}
 		m_subObjects = _value.getSubObjects();
+		_dropKeyIndex();
+		_dropValueCache();
+		return *this;
+	}
+
+	DataObject& operator = (DataObject&& _value)
+	{
+		assert(m_type == DataType::Null); // So not to overwrite the existing data
+		// Do not replace the key. Assuming that key is set upon calling DataObject[key] =
+		m_type = _value.m_type;
+		m_intVal = _value.m_intVal;
+		m_strVal = std::move(_value.m_strVal);
+		m_boolVal = _value.m_boolVal;
+		m_subObjects = std::move(_value.m_subObjects);
+		delete m_keyIndex.exchange(_value.m_keyIndex.exchange(nullptr));
+		_takeValueCache(_value);
 		return *this;
 	}
 
 	void replace(DataObject const& _value);
+	void replace(DataObject&& _value);
 
 	DataObject const& at(std::string const& _key) const;
 
 	void addArrayObject(DataObject const& _obj);
+	void addArrayObject(DataObject&& _obj);
 
 	void renameKey(std::string const& _currentKey, std::string const& _newKey);
 
@@ -101,18 +155,34 @@ class DataObject
     void clear();
 
     std::string asJson(int level = 0, bool pretty = true) const;
+    void asJson(std::ostream& _out, int level = 0, bool pretty = true) const;
     static std::string dataTypeAsString(DataType _type);
 
 	private:
-	void _addSubObject(DataObject const& _obj);
+	void _addSubObject(DataObject&& _obj);
 	void _checkDoubleKeys() const;
 	void _assert(bool _flag, std::string const& _comment = "") const;
 
+	/// Objects with many keys are searched by a hash index built on first lookup.
+	/// Keys of the subobjects must be changed through this object to keep the index valid.
+	typedef std::unordered_map<std::string, size_t> KeyIndex;  // key => position in m_subObjects
+	static size_t const npos = size_t(-1);
+	size_t _findKey(std::string const& _key) const;
+	void _dropKeyIndex();
+
+	/// Typed views of the value, built lazily by const access like the key index
+	struct ValueCache;
+	ValueCache& _valueCache() const;
+	void _dropValueCache();
+	void _takeValueCache(DataObject& _other);
+
 	std::vector<DataObject> m_subObjects;
 	DataType m_type;
 	std::string m_strKey;
 	std::string m_strVal;
-	bool m_boolVal;
-	int m_intVal;
+	bool m_boolVal = false;
+	int m_intVal = 0;
+	mutable std::atomic<KeyIndex*> m_keyIndex;  // built lazily by const lookups
+	mutable std::atomic<ValueCache*> m_valueCache;
 };
 }
@@ -0,0 +1,429 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Distributed test execution over TCP
+ */
+
+#include <arpa/inet.h>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <libdevcore/CommonData.h>
+#include <retesteth/DistributedTests.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/ExitHandler.h>
+#include <retesteth/Options.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace
+{
+bool sendLine(int _socket, string const& _line)
+{
+    string const data = _line + "\n";
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        // MSG_NOSIGNAL: a dead peer must not kill this process with SIGPIPE
+        ssize_t const ret = send(_socket, data.c_str() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (ret <= 0)
+            return false;
+        sent += ret;
+    }
+    return true;
+}
+
+bool readLine(int _socket, string& _buffer, string& _line)
+{
+    char chunk[4096];
+    size_t pos;
+    while ((pos = _buffer.find('\n')) == string::npos)
+    {
+        ssize_t const ret = recv(_socket, chunk, sizeof(chunk), 0);
+        if (ret <= 0)
+            return false;
+        _buffer.append(chunk, ret);
+    }
+    _line = _buffer.substr(0, pos);
+    _buffer.erase(0, pos + 1);
+    return true;
+}
+
+string toLine(Json::Value const& _message)
+{
+    // FastWriter escapes new lines inside strings, so the message is a single line
+    string line = Json::FastWriter().write(_message);
+    if (!line.empty() && line.back() == '\n')
+        line.pop_back();
+    return line;
+}
+
+string reply(string const& _reply)
+{
+    Json::Value message(Json::objectValue);
+    message["reply"] = _reply;
+    return toLine(message);
+}
+}  // namespace
+
+namespace test
+{
+TestCoordinator& TestCoordinator::get()
+{
+    static TestCoordinator instance(Options::get().coordinatorPort);
+    return instance;
+}
+
+TestCoordinator::TestCoordinator(unsigned short _port, unsigned _workerTimeout)
+  : m_port(_port), m_workerTimeout(_workerTimeout), m_stop(false)
+{
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    ETH_REQUIRE_MESSAGE(m_listenSocket >= 0, "Error creating coordinator socket!");
+    int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in sin;
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    sin.sin_port = htons(_port);
+    ETH_REQUIRE_MESSAGE(
+        ::bind(m_listenSocket, reinterpret_cast<struct sockaddr const*>(&sin), sizeof(sin)) == 0,
+        "Coordinator could not bind port " + dev::toString(_port));
+    ETH_REQUIRE_MESSAGE(listen(m_listenSocket, 64) == 0, "Coordinator could not listen!");
+    socklen_t sinSize = sizeof(sin);
+    if (getsockname(m_listenSocket, reinterpret_cast<struct sockaddr*>(&sin), &sinSize) == 0)
+        m_port = ntohs(sin.sin_port);
+    std::cout << "Coordinator is waiting for workers on port " << m_port << std::endl;
+    m_acceptThread = thread(&TestCoordinator::acceptConnections, this);
+}
+
+void TestCoordinator::acceptConnections()
+{
+    size_t connectionId = 0;
+    while (!m_stop)
+    {
+        // poll with a timeout to notice the shutdown
+        struct pollfd pfd;
+        pfd.fd = m_listenSocket;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, 500) <= 0)
+            continue;
+        int const sock = accept(m_listenSocket, NULL, NULL);
+        if (sock < 0)
+            continue;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        joinFinishedConnections();
+        m_connectionSockets.insert(sock);
+        m_connectionThreads[connectionId] =
+            thread(&TestCoordinator::serveConnection, this, sock, connectionId);
+        connectionId++;
+    }
+}
+
+void TestCoordinator::joinFinishedConnections()
+{
+    // A finished thread does not lock m_mutex after it is listed, so it is joined under the lock
+    for (size_t id : m_finishedConnections)
+    {
+        auto const it = m_connectionThreads.find(id);
+        if (it == m_connectionThreads.end())
+            continue;
+        it->second.join();
+        m_connectionThreads.erase(it);
+    }
+    m_finishedConnections.clear();
+}
+
+void TestCoordinator::serveConnection(int _socket, size_t _connectionId)
+{
+    string buffer;
+    string line;
+    while (!m_stop && readLine(_socket, buffer, line))
+    {
+        if (!sendLine(_socket, handleRequest(line, _connectionId)))
+            break;
+    }
+
+    // The worker has gone. Give its unfinished tests to somebody else
+    requeueTasksOf(_connectionId);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connectionSockets.erase(_socket);
+    close(_socket);
+    m_finishedConnections.push_back(_connectionId);
+    m_resultsUpdate.notify_all();  // runTasks counts the time without workers
+}
+
+string TestCoordinator::handleRequest(string const& _line, size_t _connectionId)
+{
+    Json::Value request;
+    if (!Json::Reader().parse(_line, request, false) || !request.isMember("request"))
+        return reply("error");
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    string const type = request["request"].asString();
+    if (type == "task")
+    {
+        string const queueName = request["queue"].asString();
+        if (m_closedQueues.count(queueName))
+            return reply("done");
+
+        auto const it = m_queues.find(queueName);
+        if (it == m_queues.end() || it->second.pending.empty())
+            return reply("wait");
+
+        Queue& queue = it->second;
+        Task const task = queue.pending.front();
+        queue.pending.pop_front();
+        queue.running.emplace(task.id, std::make_pair(_connectionId, task));
+
+        Json::Value message(Json::objectValue);
+        message["reply"] = "run";
+        message["id"] = Json::UInt64(task.id);
+        message["file"] = task.file.string();
+        return toLine(message);
+    }
+    else if (type == "result")
+    {
+        size_t const id = request["id"].asUInt64();
+        auto const queueIt = m_taskQueue.find(id);
+        if (queueIt == m_taskQueue.end())
+            return reply("ok");  // late result of a requeued task that has been finished already
+
+        Queue& queue = m_queues.at(queueIt->second);
+        auto const taskIt = queue.running.find(id);
+        if (taskIt == queue.running.end())
+            return reply("ok");
+
+        TaskResult result;
+        result.file = taskIt->second.second.file;
+        result.time = request["time"].asDouble();
+        for (auto const& error : request["errors"])
+            result.errors.push_back(error.asString());
+        queue.running.erase(taskIt);
+        m_taskQueue.erase(queueIt);
+        queue.finished.push_back(result);
+        m_resultsUpdate.notify_all();
+        return reply("ok");
+    }
+    return reply("error");
+}
+
+void TestCoordinator::requeueTasksOf(size_t _connectionId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& queue : m_queues)
+    {
+        auto& running = queue.second.running;
+        for (auto it = running.begin(); it != running.end();)
+        {
+            if (it->second.first == _connectionId)
+            {
+                std::cerr << "Worker disconnected. Requeue " << it->second.second.file.string()
+                          << std::endl;
+                queue.second.pending.push_front(it->second.second);
+                it = running.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+void TestCoordinator::runTasks(string const& _queue, vector<fs::path> const& _files,
+    std::function<void(TaskResult const&)> _onResult)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Queue& queue = m_queues[_queue];
+    for (auto const& file : _files)
+    {
+        Task task;
+        task.id = m_nextTaskId++;
+        task.file = file;
+        queue.pending.push_back(task);
+        m_taskQueue[task.id] = _queue;
+    }
+
+    size_t remaining = _files.size();
+    auto lastWorkerSeen = std::chrono::steady_clock::now();
+    while (remaining > 0 && !ExitHandler::shouldExit())
+    {
+        m_resultsUpdate.wait_for(lock, std::chrono::seconds(1));
+        while (!queue.finished.empty())
+        {
+            TaskResult const result = queue.finished.front();
+            queue.finished.pop_front();
+            remaining--;
+            lock.unlock();
+            _onResult(result);
+            lock.lock();
+        }
+
+        // The tasks of disconnected workers are requeued. If no worker is left to take them,
+        // the files fail instead of waiting for a worker that might never come
+        auto const now = std::chrono::steady_clock::now();
+        if (!m_connectionSockets.empty())
+            lastWorkerSeen = now;
+        else if (now - lastWorkerSeen >= std::chrono::seconds(m_workerTimeout))
+        {
+            if (!queue.pending.empty())
+                std::cerr << "No workers connected for " << m_workerTimeout
+                          << " seconds, failing the remaining tests of " << _queue << std::endl;
+            while (!queue.pending.empty())
+            {
+                TaskResult result;
+                result.file = queue.pending.front().file;
+                result.time = 0;
+                result.errors.push_back("Test was not executed: no workers are connected");
+                m_taskQueue.erase(queue.pending.front().id);
+                queue.pending.pop_front();
+                remaining--;
+                lock.unlock();
+                _onResult(result);
+                lock.lock();
+            }
+        }
+    }
+
+    for (auto const& task : queue.pending)
+        m_taskQueue.erase(task.id);
+    for (auto const& task : queue.running)
+        m_taskQueue.erase(task.first);
+    m_queues.erase(_queue);
+    m_closedQueues.insert(_queue);
+}
+
+void TestCoordinator::shutdown()
+{
+    if (m_stop)
+        return;
+    m_stop = true;
+    m_acceptThread.join();
+    vector<thread> connectionThreads;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int sock : m_connectionSockets)
+            ::shutdown(sock, SHUT_RDWR);  // wake up the blocked recv
+        for (auto& th : m_connectionThreads)
+            connectionThreads.push_back(std::move(th.second));
+        m_connectionThreads.clear();
+        m_finishedConnections.clear();
+    }
+    for (auto& th : connectionThreads)
+        th.join();
+    close(m_listenSocket);
+}
+
+TestWorker& TestWorker::get()
+{
+    static TestWorker instance(Options::get().workerAddress);
+    return instance;
+}
+
+TestWorker::TestWorker(string const& _address) : m_connected(false)
+{
+    size_t const pos = _address.find_last_of(':');
+    ETH_REQUIRE_MESSAGE(pos != string::npos, "--worker expects <ip:port>, got: " + _address);
+    struct sockaddr_in sin;
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = inet_addr(_address.substr(0, pos).c_str());
+    sin.sin_port = htons(atoi(_address.substr(pos + 1).c_str()));
+
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    ETH_REQUIRE_MESSAGE(m_socket >= 0, "Error creating worker socket!");
+
+    // The coordinator might be started a bit later than the workers
+    for (int attempt = 0; attempt < 60 && !ExitHandler::shouldExit(); attempt++)
+    {
+        if (connect(m_socket, reinterpret_cast<struct sockaddr const*>(&sin), sizeof(sin)) == 0)
+        {
+            m_connected = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    ETH_REQUIRE_MESSAGE(m_connected, "Could not connect to the coordinator at " + _address);
+}
+
+TestWorker::~TestWorker()
+{
+    if (m_connected)
+        close(m_socket);
+}
+
+bool TestWorker::exchange(string const& _request, string& _reply)
+{
+    std::lock_guard<std::mutex> lock(m_socketMutex);
+    if (!m_connected)
+        return false;
+    if (!sendLine(m_socket, _request) || !readLine(m_socket, m_readBuffer, _reply))
+    {
+        std::cerr << "Lost connection to the coordinator!" << std::endl;
+        m_connected = false;
+        close(m_socket);
+        return false;
+    }
+    return true;
+}
+
+TestWorker::TaskStatus TestWorker::requestTask(
+    string const& _queue, size_t& _taskId, fs::path& _file)
+{
+    Json::Value request(Json::objectValue);
+    request["request"] = "task";
+    request["queue"] = _queue;
+
+    string line;
+    Json::Value response;
+    if (!exchange(toLine(request), line) || !Json::Reader().parse(line, response, false))
+        return TaskStatus::Done;
+
+    string const status = response["reply"].asString();
+    if (status == "run")
+    {
+        _taskId = response["id"].asUInt64();
+        _file = response["file"].asString();
+        return TaskStatus::Run;
+    }
+    if (status == "wait")
+        return TaskStatus::Wait;
+    return TaskStatus::Done;
+}
+
+void TestWorker::sendResult(size_t _taskId, double _time, vector<string> const& _errors)
+{
+    Json::Value request(Json::objectValue);
+    request["request"] = "result";
+    request["id"] = Json::UInt64(_taskId);
+    request["time"] = _time;
+    request["errors"] = Json::Value(Json::arrayValue);
+    for (auto const& error : _errors)
+        request["errors"].append(error);
+
+    string line;
+    exchange(toLine(request), line);
+}
+
+}  // namespace test
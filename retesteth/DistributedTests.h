@@ -0,0 +1,139 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Distributed test execution. A coordinator (--coordinator <port>) serves test files to
+ * worker processes (--worker <ip:port>) that run them against their local clients.
+ *
+ * Both sides run the same test suites. When the coordinator reaches a test folder it opens a
+ * queue with the folder's files, workers that reach the same folder pull the files one by one
+ * and send the results back. The protocol is one json object per line over TCP.
+ */
+
+#pragma once
+#include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test
+{
+class TestCoordinator
+{
+public:
+    struct TaskResult
+    {
+        boost::filesystem::path file;  ///< relative to the test path
+        double time;
+        std::vector<std::string> errors;
+    };
+
+    /// Start listening on --coordinator port on first use
+    static TestCoordinator& get();
+
+    /// Listen on _port, 0 picks a free port. Files of a queue fail if no worker is connected
+    /// for _workerTimeout seconds
+    TestCoordinator(unsigned short _port, unsigned _workerTimeout = 120);
+    unsigned short port() const { return m_port; }
+
+    /// Serve _files to the workers under the _queue name and block until every file has a
+    /// result. _onResult is called on the calling thread for each result as it arrives.
+    void runTasks(std::string const& _queue, std::vector<boost::filesystem::path> const& _files,
+        std::function<void(TaskResult const&)> _onResult);
+
+    /// Stop the server and disconnect the workers
+    void shutdown();
+    ~TestCoordinator() { shutdown(); }
+
+private:
+    TestCoordinator(TestCoordinator const&) = delete;
+    void acceptConnections();
+    void joinFinishedConnections();
+    void serveConnection(int _socket, size_t _connectionId);
+    std::string handleRequest(std::string const& _line, size_t _connectionId);
+    void requeueTasksOf(size_t _connectionId);
+
+    struct Task
+    {
+        size_t id;
+        boost::filesystem::path file;
+    };
+    struct Queue
+    {
+        std::deque<Task> pending;
+        std::map<size_t, std::pair<size_t, Task>> running;  ///< task id => (connection, task)
+        std::deque<TaskResult> finished;
+    };
+
+    int m_listenSocket;
+    unsigned short m_port;
+    unsigned const m_workerTimeout;
+    std::atomic<bool> m_stop;
+    std::thread m_acceptThread;
+    std::map<size_t, std::thread> m_connectionThreads;  ///< by connection id
+    std::vector<size_t> m_finishedConnections;          ///< threads to join
+    std::set<int> m_connectionSockets;
+
+    std::mutex m_mutex;
+    std::condition_variable m_resultsUpdate;
+    std::map<std::string, Queue> m_queues;
+    std::map<size_t, std::string> m_taskQueue;  ///< task id => queue name
+    std::set<std::string> m_closedQueues;
+    size_t m_nextTaskId = 0;
+};
+
+class TestWorker
+{
+public:
+    enum class TaskStatus
+    {
+        Run,   // execute the returned file
+        Wait,  // the queue is not opened yet or other workers still execute its last tests
+        Done   // the queue is finished or the coordinator has gone
+    };
+
+    /// Connect to --worker address on first use
+    static TestWorker& get();
+
+    /// Connect to the coordinator at <ip:port>
+    TestWorker(std::string const& _address);
+
+    /// Ask the coordinator for the next file of _queue
+    TaskStatus requestTask(
+        std::string const& _queue, size_t& _taskId, boost::filesystem::path& _file);
+
+    /// Send the result of a task to the coordinator
+    void sendResult(size_t _taskId, double _time, std::vector<std::string> const& _errors);
+    ~TestWorker();
+
+private:
+    TestWorker(TestWorker const&) = delete;
+    bool exchange(std::string const& _request, std::string& _reply);
+
+    int m_socket;
+    bool m_connected;
+    std::string m_readBuffer;
+    std::mutex m_socketMutex;  ///< test threads send results while the main thread asks for tasks
+};
+
+}  // namespace test
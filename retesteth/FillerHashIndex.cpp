@@ -0,0 +1,285 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Index of filler hashes to check that the tests are up to date without parsing them
+ */
+
+#include <json/reader.h>
+#include <json/writer.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/ExitHandler.h>
+#include <retesteth/FillerHashIndex.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestFileCache.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/TestOutputHelper.h>
+#include <atomic>
+#include <functional>
+#include <set>
+#include <thread>
+
+using namespace std;
+using namespace dev;
+namespace fs = boost::filesystem;
+
+namespace test
+{
+h256 fillerJsonHash(Json::Value const& _filler)
+{
+    string output = Json::FastWriter().write(_filler);
+    output = output.substr(0, output.size() - 1);
+    return sha3(output);
+}
+
+FillerHashIndex& FillerHashIndex::get()
+{
+    static FillerHashIndex instance;
+    return instance;
+}
+
+FillerHashIndex::FillerHashIndex()
+{
+    m_indexFile = getTestPath() / "Retesteth" / "fillerHashIndex.json";
+    if (!fs::exists(m_indexFile))
+        return;
+
+    // A broken index is rebuilt from the test files
+    Json::Value index;
+    if (!Json::Reader().parse(dev::contentsString(m_indexFile), index, false) || !index.isObject())
+        return;
+    try
+    {
+        Json::Value const& compiled = index["compiled"];
+        for (auto const& path : compiled.getMemberNames())
+        {
+            CompiledEntry entry;
+            entry.stamp.size = compiled[path]["size"].asUInt64();
+            entry.stamp.mtime = compiled[path]["mtime"].asInt64();
+            Json::Value const& hashes = compiled[path]["sourceHashes"];
+            for (auto const& test : hashes.getMemberNames())
+                entry.sourceHashes.push_back({test, h256(hashes[test].asString())});
+            m_compiled[path] = entry;
+        }
+        Json::Value const& fillers = index["fillers"];
+        for (auto const& path : fillers.getMemberNames())
+        {
+            FillerEntry entry;
+            entry.stamp.size = fillers[path]["size"].asUInt64();
+            entry.stamp.mtime = fillers[path]["mtime"].asInt64();
+            entry.hash = h256(fillers[path]["hash"].asString());
+            m_fillers[path] = entry;
+        }
+    }
+    catch (std::exception const&)
+    {
+        m_compiled.clear();
+        m_fillers.clear();
+    }
+}
+
+void FillerHashIndex::save() const
+{
+    Json::Value index(Json::objectValue);
+    index["compiled"] = Json::Value(Json::objectValue);
+    for (auto const& entry : m_compiled)
+    {
+        Json::Value value(Json::objectValue);
+        value["size"] = Json::UInt64(entry.second.stamp.size);
+        value["mtime"] = Json::Int64(entry.second.stamp.mtime);
+        value["sourceHashes"] = Json::Value(Json::objectValue);
+        for (auto const& hash : entry.second.sourceHashes)
+            value["sourceHashes"][hash.first] = toHexPrefixed(hash.second);
+        index["compiled"][entry.first] = value;
+    }
+    index["fillers"] = Json::Value(Json::objectValue);
+    for (auto const& entry : m_fillers)
+    {
+        Json::Value value(Json::objectValue);
+        value["size"] = Json::UInt64(entry.second.stamp.size);
+        value["mtime"] = Json::Int64(entry.second.stamp.mtime);
+        value["hash"] = toHexPrefixed(entry.second.hash);
+        index["fillers"][entry.first] = value;
+    }
+
+    // The index is only a cache. Tests are fine without it
+    try
+    {
+        dev::writeFile(m_indexFile, asBytes(Json::FastWriter().write(index)), true);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_TEST_MESSAGE("Could not save filler hash index: " + string(_ex.what()));
+    }
+}
+
+FillerHashIndex::FileStamp FillerHashIndex::stampOf(fs::path const& _file)
+{
+    FileStamp stamp;
+    stamp.size = fs::file_size(_file);
+    stamp.mtime = fs::last_write_time(_file);
+    return stamp;
+}
+
+bool FillerHashIndex::readSourceHashes(
+    fs::path const& _compiledTest, vector<pair<string, h256>>& o_hashes)
+{
+    o_hashes.clear();
+    // the test is executed later from the same cache entry
+    std::shared_ptr<DataObject const> v = TestFileCache::get().load(_compiledTest);
+    if (v->type() == DataType::Null)
+        return false;
+    for (auto const& i : v->getSubObjects())
+    {
+        // use eth object _info section class here !!!!!
+        ETH_REQUIRE_MESSAGE(i.type() == DataType::Object, i.getKey() + " should contain an object under a test name.");
+        ETH_REQUIRE_MESSAGE(i.count("_info") > 0, "_info section not set! " + _compiledTest.string());
+        DataObject const& info = i.at("_info");
+        ETH_REQUIRE_MESSAGE(info.count("sourceHash") > 0, "sourceHash not found in " + _compiledTest.string() + " in " + i.getKey());
+        o_hashes.push_back({i.getKey(), h256(info.at("sourceHash").asString())});
+    }
+    return true;
+}
+
+bool FillerHashIndex::readFillerHash(fs::path const& _filler, h256& o_hash)
+{
+    Json::Value const filler = readJson(_filler);
+    if (filler.isNull())
+        return false;
+    o_hash = fillerJsonHash(filler);
+    return true;
+}
+
+void FillerHashIndex::checkFillerHashes(vector<pair<fs::path, fs::path>> const& _tests)
+{
+    // Stat pass. Collect the files that are not in the index or have been modified
+    fs::path const testPath = getTestPath();
+    vector<fs::path> staleCompiled;
+    vector<fs::path> staleFillers;
+    set<string> seen;
+    for (auto const& test : _tests)
+    {
+        string const compiledKey = fs::relative(test.first, testPath).string();
+        auto const compiled = m_compiled.find(compiledKey);
+        if (seen.insert(compiledKey).second &&
+            (compiled == m_compiled.end() || !(compiled->second.stamp == stampOf(test.first))))
+            staleCompiled.push_back(test.first);
+
+        string const fillerKey = fs::relative(test.second, testPath).string();
+        auto const filler = m_fillers.find(fillerKey);
+        if (seen.insert(fillerKey).second &&
+            (filler == m_fillers.end() || !(filler->second.stamp == stampOf(test.second))))
+            staleFillers.push_back(test.second);
+    }
+
+    // Parse the stale files in parallel
+    size_t const jobCount = staleCompiled.size() + staleFillers.size();
+    vector<CompiledEntry> compiledResults(staleCompiled.size());
+    vector<FillerEntry> fillerResults(staleFillers.size());
+    auto readCompiled = [&](size_t _i) {
+        compiledResults[_i].stamp = stampOf(staleCompiled[_i]);
+        return readSourceHashes(staleCompiled[_i], compiledResults[_i].sourceHashes);
+    };
+    auto readFiller = [&](size_t _i) {
+        fillerResults[_i].stamp = stampOf(staleFillers[_i]);
+        return readFillerHash(staleFillers[_i], fillerResults[_i].hash);
+    };
+    vector<char> failed(jobCount, false);
+    std::atomic<size_t> nextJob(0);
+    auto worker = [&]() {
+        for (size_t job = nextJob++; job < jobCount && !ExitHandler::shouldExit(); job = nextJob++)
+        {
+            // The errors are not reported on the worker threads, the main thread reads the
+            // failed files again
+            TestOutputHelper& helper = TestOutputHelper::get();
+            size_t const errorCount = helper.getErrors().size();
+            try
+            {
+                if (job < staleCompiled.size())
+                    failed[job] = !readCompiled(job);
+                else
+                    failed[job] = !readFiller(job - staleCompiled.size());
+            }
+            catch (...)
+            {
+                failed[job] = true;
+            }
+            if (helper.getErrors().size() != errorCount)
+                failed[job] = true;
+            helper.dropErrors(errorCount);
+        }
+    };
+    vector<thread> threads;
+    size_t const threadCount = min<size_t>(max<size_t>(Options::get().threadCount, 1), jobCount);
+    for (size_t i = 0; i < threadCount; i++)
+        threads.push_back(thread(worker));
+    for (auto& th : threads)
+        th.join();
+    if (ExitHandler::shouldExit())
+        return;
+
+    // Failed files are read again on this thread to report the error. Only the files that
+    // are read without errors get an entry, the others are checked again by the next run
+    auto readReported = [](fs::path const& _file, std::function<bool()> const& _read) {
+        TestOutputHelper& helper = TestOutputHelper::get();
+        size_t const errorCount = helper.getErrors().size();
+        bool const parsed = _read();
+        if (!parsed && helper.getErrors().size() == errorCount)
+            ETH_ERROR("Could not read " + _file.string());
+        return parsed && helper.getErrors().size() == errorCount;
+    };
+    for (size_t i = 0; i < staleCompiled.size(); i++)
+    {
+        string const key = fs::relative(staleCompiled[i], testPath).string();
+        if (!failed[i] || readReported(staleCompiled[i], [&]() { return readCompiled(i); }))
+            m_compiled[key] = compiledResults[i];
+        else
+            m_compiled.erase(key);
+    }
+    for (size_t i = 0; i < staleFillers.size(); i++)
+    {
+        string const key = fs::relative(staleFillers[i], testPath).string();
+        if (!failed[staleCompiled.size() + i] ||
+            readReported(staleFillers[i], [&]() { return readFiller(i); }))
+            m_fillers[key] = fillerResults[i];
+        else
+            m_fillers.erase(key);
+    }
+    if (jobCount)
+        save();
+
+    for (auto const& test : _tests)
+    {
+        // The files without an entry have failed with an error above
+        auto const filler = m_fillers.find(fs::relative(test.second, testPath).string());
+        auto const compiled = m_compiled.find(fs::relative(test.first, testPath).string());
+        if (filler == m_fillers.end() || compiled == m_compiled.end())
+            continue;
+        h256 const& fillerHash = filler->second.hash;
+        for (auto const& i : compiled->second.sourceHashes)
+        {
+            h256 const& sourceHash = i.second;
+            ETH_CHECK_MESSAGE(sourceHash == fillerHash,
+                "Test " + test.first.string() + " in " + i.first +
+                    " is outdated. Filler hash is different! ( '" + sourceHash.hex().substr(0, 4) +
+                    "' != '" + fillerHash.hex().substr(0, 4) + "') ");
+        }
+    }
+}
+
+}  // namespace test
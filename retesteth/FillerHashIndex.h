@@ -0,0 +1,84 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Index of filler hashes to check that the tests are up to date without parsing them
+ */
+
+#pragma once
+#include <json/value.h>
+#include <libdevcore/FixedHash.h>
+#include <boost/filesystem/path.hpp>
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace test
+{
+/// Hash of the filler json that generated tests keep in _info.sourceHash
+dev::h256 fillerJsonHash(Json::Value const& _filler);
+
+/// The hashes of compiled tests and fillers are kept in <testpath>/Retesteth/fillerHashIndex.json
+/// with the size and modification time of the files. Only new or modified files are parsed.
+class FillerHashIndex
+{
+public:
+    static FillerHashIndex& get();
+
+    /// Check that each compiled test of a (compiled, filler) pair is generated from the filler.
+    /// Modified files are parsed on --jN threads.
+    void checkFillerHashes(
+        std::vector<std::pair<boost::filesystem::path, boost::filesystem::path>> const& _tests);
+
+private:
+    FillerHashIndex();
+    FillerHashIndex(FillerHashIndex const&) = delete;
+    void save() const;
+
+    struct FileStamp
+    {
+        uintmax_t size = 0;
+        std::time_t mtime = 0;
+        bool operator==(FileStamp const& _other) const
+        {
+            return size == _other.size && mtime == _other.mtime;
+        }
+    };
+    struct CompiledEntry
+    {
+        FileStamp stamp;
+        std::vector<std::pair<std::string, dev::h256>> sourceHashes;  ///< test => _info.sourceHash
+    };
+    struct FillerEntry
+    {
+        FileStamp stamp;
+        dev::h256 hash;
+    };
+
+    static FileStamp stampOf(boost::filesystem::path const& _file);
+    /// Read the entry of a file. Returns false if the file could not be parsed
+    static bool readSourceHashes(boost::filesystem::path const& _compiledTest,
+        std::vector<std::pair<std::string, dev::h256>>& o_hashes);
+    static bool readFillerHash(boost::filesystem::path const& _filler, dev::h256& o_hash);
+
+    boost::filesystem::path m_indexFile;
+    std::map<std::string, CompiledEntry> m_compiled;  ///< path relative to the test path
+    std::map<std::string, FillerEntry> m_fillers;     ///< path relative to the test path
+};
+
+}  // namespace test
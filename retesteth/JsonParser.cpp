@@ -0,0 +1,546 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Json parser that builds DataObject directly, without the jsoncpp tree in between
+ */
+
+#include <retesteth/JsonParser.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+using namespace test;
+
+namespace
+{
+/// Same nesting limit as jsoncpp
+size_t const c_maxDepth = 1000;
+
+/// First '"' or '\' in [_pos, _end), or _end
+/// Test files are mostly long hex strings, so they are scanned 16 bytes at a time
+char const* findQuoteOrEscape(char const* _pos, char const* _end)
+{
+#if defined(__SSE2__)
+    __m128i const quote = _mm_set1_epi8('"');
+    __m128i const escape = _mm_set1_epi8('\\');
+    for (; _end - _pos >= 16; _pos += 16)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_pos));
+        int const mask = _mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape)));
+        if (mask != 0)
+            return _pos + __builtin_ctz(mask);
+    }
+#endif
+    for (; _pos < _end; _pos++)
+        if (*_pos == '"' || *_pos == '\\')
+            return _pos;
+    return _end;
+}
+
+/// First non whitespace character in [_pos, _end), or _end
+/// Indentation of pretty printed files is skipped 16 bytes at a time
+char const* skipSpaces(char const* _pos, char const* _end)
+{
+#if defined(__SSE2__)
+    __m128i const space = _mm_set1_epi8(' ');
+    __m128i const newLine = _mm_set1_epi8('\n');
+    __m128i const carriageReturn = _mm_set1_epi8('\r');
+    __m128i const tab = _mm_set1_epi8('\t');
+    for (; _end - _pos >= 16; _pos += 16)
+    {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_pos));
+        __m128i const spaces = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newLine)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn), _mm_cmpeq_epi8(chunk, tab)));
+        int const mask = _mm_movemask_epi8(spaces) ^ 0xFFFF;
+        if (mask != 0)
+            return _pos + __builtin_ctz(mask);
+    }
+#endif
+    while (_pos < _end && (*_pos == ' ' || *_pos == '\n' || *_pos == '\r' || *_pos == '\t'))
+        _pos++;
+    return _pos;
+}
+
+void appendUtf8(string& _out, unsigned _codePoint)
+{
+    if (_codePoint < 0x80)
+        _out += char(_codePoint);
+    else if (_codePoint < 0x800)
+    {
+        _out += char(0xC0 | (_codePoint >> 6));
+        _out += char(0x80 | (_codePoint & 0x3F));
+    }
+    else if (_codePoint < 0x10000)
+    {
+        _out += char(0xE0 | (_codePoint >> 12));
+        _out += char(0x80 | ((_codePoint >> 6) & 0x3F));
+        _out += char(0x80 | (_codePoint & 0x3F));
+    }
+    else
+    {
+        _out += char(0xF0 | (_codePoint >> 18));
+        _out += char(0x80 | ((_codePoint >> 12) & 0x3F));
+        _out += char(0x80 | ((_codePoint >> 6) & 0x3F));
+        _out += char(0x80 | (_codePoint & 0x3F));
+    }
+}
+
+class JsonParser
+{
+public:
+    JsonParser(string const& _input, JsonMemberFilter const& _filter)
+      : m_begin(_input.data()),
+        m_pos(_input.data()),
+        m_end(_input.data() + _input.size()),
+        m_filter(_filter)
+    {}
+
+    DataObject parse(string& _error)
+    {
+        DataObject root;
+        skipWhitespace();
+        if (parseValue(root, 0))
+        {
+            skipWhitespace();
+            if (m_pos != m_end)
+                fail("Extra characters after the json value");
+        }
+        if (!m_error.empty())
+        {
+            _error = m_error;
+            return DataObject(DataType::Null);
+        }
+        return root;
+    }
+
+private:
+    /// Spaces and comments, jsoncpp allows both // and /* */ comments
+    void skipWhitespace()
+    {
+        while (true)
+        {
+            m_pos = skipSpaces(m_pos, m_end);
+            if (m_end - m_pos < 2 || m_pos[0] != '/')
+                return;
+            if (m_pos[1] == '/')
+                m_pos = find(m_pos, m_end, '\n');
+            else if (m_pos[1] == '*')
+            {
+                char const* const commentEnd = "*/";
+                char const* const close = search(m_pos + 2, m_end, commentEnd, commentEnd + 2);
+                if (close == m_end)
+                {
+                    fail("Comment is not closed");
+                    return;
+                }
+                m_pos = close + 2;
+            }
+            else
+                return;
+        }
+    }
+
+    bool parseValue(DataObject& _out, size_t _depth)
+    {
+        if (m_pos == m_end)
+            return fail("Unexpected end of json");
+        switch (*m_pos)
+        {
+        case '{':
+            return parseObject(_out, _depth + 1);
+        case '[':
+            return parseArray(_out, _depth + 1);
+        case '"':
+        {
+            string value;
+            if (!parseString(value))
+                return false;
+            _out = value;
+            return true;
+        }
+        case 't':
+            return parseLiteral("true", DataObject(DataType::Bool, true), _out);
+        case 'f':
+            return parseLiteral("false", DataObject(DataType::Bool, false), _out);
+        case 'n':
+            return parseLiteral("null", DataObject(DataType::Null), _out);
+        default:
+            if (*m_pos == '-' || (*m_pos >= '0' && *m_pos <= '9'))
+                return parseNumber(_out);
+            return fail("Syntax error: value, object or array expected.");
+        }
+    }
+
+    bool parseObject(DataObject& _out, size_t _depth)
+    {
+        if (_depth > c_maxDepth)
+            return fail("Exceeded json nesting limit");
+        m_pos++;  // {
+        vector<DataObject> members;
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == '}')
+            m_pos++;
+        else
+        {
+            string key;
+            while (true)
+            {
+                skipWhitespace();
+                if (m_pos == m_end || *m_pos != '"')
+                    return fail("Missing '\"' at the beginning of an object member name");
+                if (!parseString(key))
+                    return false;
+                skipWhitespace();
+                if (m_pos == m_end || *m_pos != ':')
+                    return fail("Missing ':' after object member name");
+                m_pos++;
+                skipWhitespace();
+                if (_depth == 1 && m_filter && !m_filter(key))
+                {
+                    if (!skipValue())
+                        return false;
+                }
+                else
+                {
+                    members.emplace_back();
+                    if (!parseValue(members.back(), _depth))
+                        return false;
+                    members.back().setKey(key);
+                }
+                skipWhitespace();
+                if (m_pos < m_end && *m_pos == ',')
+                {
+                    m_pos++;
+                    continue;
+                }
+                if (m_pos < m_end && *m_pos == '}')
+                {
+                    m_pos++;
+                    break;
+                }
+                return fail("Missing ',' or '}' in object declaration");
+            }
+        }
+
+        // jsoncpp keeps the members in a map, the test suites expect them sorted by key
+        auto const byKey = [](DataObject const& _a, DataObject const& _b) {
+            return _a.getKey() < _b.getKey();
+        };
+        if (!is_sorted(members.begin(), members.end(), byKey))
+        {
+            vector<size_t> order(members.size());
+            iota(order.begin(), order.end(), 0);
+            sort(order.begin(), order.end(), [&members, &byKey](size_t _a, size_t _b) {
+                return byKey(members[_a], members[_b]);
+            });
+            vector<DataObject> sorted;
+            sorted.reserve(members.size());
+            for (size_t i : order)
+                sorted.push_back(std::move(members[i]));
+            members.swap(sorted);
+        }
+        for (size_t i = 1; i < members.size(); i++)
+            if (!members[i].getKey().empty() && members[i].getKey() == members[i - 1].getKey())
+                return fail("Double key '" + members[i].getKey() + "' in the object");
+
+        _out = DataObject(DataType::Object);
+        _out.getSubObjectsUnsafe().swap(members);
+        return true;
+    }
+
+    bool parseArray(DataObject& _out, size_t _depth)
+    {
+        if (_depth > c_maxDepth)
+            return fail("Exceeded json nesting limit");
+        m_pos++;  // [
+        vector<DataObject> elements;
+        skipWhitespace();
+        if (m_pos < m_end && *m_pos == ']')
+            m_pos++;
+        else
+        {
+            while (true)
+            {
+                skipWhitespace();
+                elements.emplace_back();
+                if (!parseValue(elements.back(), _depth))
+                    return false;
+                skipWhitespace();
+                if (m_pos < m_end && *m_pos == ',')
+                {
+                    m_pos++;
+                    continue;
+                }
+                if (m_pos < m_end && *m_pos == ']')
+                {
+                    m_pos++;
+                    break;
+                }
+                return fail("Missing ',' or ']' in array declaration");
+            }
+        }
+        _out = DataObject(DataType::Array);
+        _out.getSubObjectsUnsafe().swap(elements);
+        return true;
+    }
+
+    /// Step over a value without building it
+    bool skipValue()
+    {
+        if (m_pos == m_end || (*m_pos != '{' && *m_pos != '['))
+        {
+            DataObject scalar;
+            return parseValue(scalar, 0);
+        }
+
+        string closing;  // brackets that are still open, innermost last
+        while (true)
+        {
+            char const c = *m_pos;
+            if (c == '"')
+            {
+                if (!skipString())
+                    return false;
+            }
+            else if (c == '{' || c == '[')
+            {
+                if (closing.size() == c_maxDepth)
+                    return fail("Exceeded json nesting limit");
+                closing += (c == '{') ? '}' : ']';
+                m_pos++;
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (c != closing.back())
+                    return fail(string("Syntax error: '") + closing.back() + "' expected.");
+                closing.pop_back();
+                m_pos++;
+                if (closing.empty())
+                    return true;
+            }
+            else
+                m_pos++;
+            skipWhitespace();
+            if (m_pos == m_end)
+                return fail("Unexpected end of json");
+        }
+    }
+
+    bool skipString()
+    {
+        m_pos++;  // "
+        while (true)
+        {
+            m_pos = findQuoteOrEscape(m_pos, m_end);
+            if (m_pos == m_end)
+                return fail("Missing '\"' at the end of a string");
+            if (*m_pos++ == '"')
+                return true;
+            if (m_pos == m_end)
+                return fail("Missing '\"' at the end of a string");
+            m_pos++;  // escaped character
+        }
+    }
+
+    bool parseString(string& _out)
+    {
+        m_pos++;  // "
+        _out.clear();
+        while (true)
+        {
+            char const* const special = findQuoteOrEscape(m_pos, m_end);
+            _out.append(m_pos, special);
+            m_pos = special;
+            if (m_pos == m_end)
+                return fail("Missing '\"' at the end of a string");
+            if (*m_pos++ == '"')
+                return true;
+
+            if (m_pos == m_end)
+                return fail("Missing '\"' at the end of a string");
+            switch (*m_pos++)
+            {
+            case '"': _out += '"'; break;
+            case '/': _out += '/'; break;
+            case '\\': _out += '\\'; break;
+            case 'b': _out += '\b'; break;
+            case 'f': _out += '\f'; break;
+            case 'n': _out += '\n'; break;
+            case 'r': _out += '\r'; break;
+            case 't': _out += '\t'; break;
+            case 'u':
+            {
+                unsigned codePoint;
+                if (!parseUnicode(codePoint))
+                    return false;
+                appendUtf8(_out, codePoint);
+                break;
+            }
+            default:
+                m_pos--;
+                return fail("Bad escape sequence in string");
+            }
+        }
+    }
+
+    bool parseHex4(unsigned& _value)
+    {
+        if (m_end - m_pos < 4)
+            return fail("Bad unicode escape sequence in string: four digits expected.");
+        _value = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            char const c = *m_pos++;
+            _value <<= 4;
+            if (c >= '0' && c <= '9')
+                _value += c - '0';
+            else if (c >= 'a' && c <= 'f')
+                _value += c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                _value += c - 'A' + 10;
+            else
+                return fail("Bad unicode escape sequence in string: hexadecimal digit expected.");
+        }
+        return true;
+    }
+
+    bool parseUnicode(unsigned& _codePoint)
+    {
+        if (!parseHex4(_codePoint))
+            return false;
+        if (_codePoint >= 0xD800 && _codePoint <= 0xDBFF)
+        {
+            // surrogate pair
+            unsigned low;
+            if (m_end - m_pos < 6 || m_pos[0] != '\\' || m_pos[1] != 'u')
+                return fail("Additional six characters expected to parse unicode surrogate pair.");
+            m_pos += 2;
+            if (!parseHex4(low))
+                return false;
+            if (low < 0xDC00 || low > 0xDFFF)
+                return fail("Bad unicode surrogate pair in string");
+            _codePoint = 0x10000 + ((_codePoint & 0x3FF) << 10) + (low & 0x3FF);
+        }
+        return true;
+    }
+
+    bool parseLiteral(char const* _literal, DataObject&& _value, DataObject& _out)
+    {
+        size_t const length = strlen(_literal);
+        if (size_t(m_end - m_pos) < length || memcmp(m_pos, _literal, length) != 0)
+            return fail("Syntax error: value, object or array expected.");
+        m_pos += length;
+        if (_value.type() != DataType::Null)
+            _out = std::move(_value);
+        return true;
+    }
+
+    /// DataObject only keeps int. Other numbers were not accepted by convertJsonCPPtoData
+    bool parseNumber(DataObject& _out)
+    {
+        char const* const start = m_pos;
+        bool integer = true;
+        if (*m_pos == '-')
+            m_pos++;
+        for (; m_pos < m_end; m_pos++)
+        {
+            char const c = *m_pos;
+            if (c >= '0' && c <= '9')
+                continue;
+            if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+                integer = false;
+            else
+                break;
+        }
+
+        string const token(start, m_pos);
+        if (integer)
+        {
+            bool const negative = token[0] == '-';
+            long long value = 0;
+            size_t const first = negative ? 1 : 0;
+            if (token.size() == first)
+                return fail("'" + token + "' is not a number.");
+            for (size_t i = first; i < token.size(); i++)
+            {
+                value = value * 10 + (token[i] - '0');
+                if (value > (long long)INT_MAX + 1)
+                    return fail("'" + token + "' is out of int range.");
+            }
+            if (negative)
+                value = -value;
+            if (value > INT_MAX || value < INT_MIN)
+                return fail("'" + token + "' is out of int range.");
+            _out = int(value);
+            return true;
+        }
+
+        char* end = nullptr;
+        double const value = strtod(token.c_str(), &end);
+        if (end != token.c_str() + token.size())
+            return fail("'" + token + "' is not a number.");
+        if (value < INT_MIN || value > INT_MAX || value != floor(value))
+            return fail("'" + token + "' is not an int value.");
+        _out = int(value);
+        return true;
+    }
+
+    bool fail(string const& _message)
+    {
+        if (!m_error.empty())
+            return false;  // keep the first error
+        size_t line = 1;
+        char const* lineStart = m_begin;
+        for (char const* pos = m_begin; pos < m_pos && pos < m_end; pos++)
+        {
+            if (*pos == '\n')
+            {
+                line++;
+                lineStart = pos + 1;
+            }
+        }
+        m_error = "* Line " + to_string(line) + ", Column " + to_string(m_pos - lineStart + 1) +
+                  "\n  " + _message + "\n";
+        return false;
+    }
+
+    char const* const m_begin;
+    char const* m_pos;
+    char const* const m_end;
+    JsonMemberFilter const& m_filter;
+    string m_error;
+};
+}  // namespace
+
+namespace test
+{
+DataObject parseJsonData(string const& _input, string& _error, JsonMemberFilter const& _filter)
+{
+    _error.clear();
+    return JsonParser(_input, _filter).parse(_error);
+}
+
+}  // namespace test
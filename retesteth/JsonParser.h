@@ -0,0 +1,40 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Json parser that builds DataObject directly, without the jsoncpp tree in between
+ */
+
+#pragma once
+#include <retesteth/DataObject.h>
+#include <functional>
+#include <string>
+
+namespace test
+{
+/// Selects the members of the top level object that parseJsonData builds
+typedef std::function<bool(std::string const& _key)> JsonMemberFilter;
+
+/// Parse json text into DataObject. The result is the same as convertJsonCPPtoData of the
+/// jsoncpp tree: object members are sorted by key, numbers must be integers in int range.
+/// Double keys in an object are an error (jsoncpp would keep the last one silently).
+/// On error _error describes the problem with its line and column, Null is returned.
+/// Top level members rejected by _filter are stepped over without being built: only their
+/// strings and brackets are matched, so most syntax errors inside them are not reported.
+DataObject parseJsonData(std::string const& _input, std::string& _error,
+    JsonMemberFilter const& _filter = JsonMemberFilter());
+
+}  // namespace test
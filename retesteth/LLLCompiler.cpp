@@ -0,0 +1,259 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Compile LLL code ahead of the execution and keep the bytecode between runs
+ */
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/LLLCompiler.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+using namespace dev;
+namespace fs = boost::filesystem;
+
+namespace
+{
+/// Runs _command and reads its output into o_output. Nothing is reported, the compiler threads
+/// leave that to the test threads. Returns the exit code, -1 if the command could not be run
+int runCommand(string const& _command, string& o_output)
+{
+#if defined(_WIN32)
+    (void)_command;
+    (void)o_output;
+    return -1;
+#else
+    FILE* fp = popen(_command.c_str(), "r");
+    if (fp == NULL)
+        return -1;
+    char buffer[1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        o_output.append(buffer, read);
+    int const exitCode = pclose(fp);
+    boost::trim(o_output);
+    return exitCode;
+#endif
+}
+
+bool isLLL(string const& _code)
+{
+    return !_code.empty() && _code.compare(0, 2, "0x") != 0;
+}
+
+/// A cache entry is the hash of the bytecode and the bytecode on the next line
+string makeCacheEntry(string const& _bytecode)
+{
+    return toHex(sha3(_bytecode)) + "\n" + _bytecode;
+}
+
+/// The bytecode of a cache entry, empty if the entry is truncated or broken
+string readCacheEntry(string const& _entry)
+{
+    size_t const pos = _entry.find('\n');
+    if (pos == string::npos)
+        return string();
+    string const bytecode = _entry.substr(pos + 1);
+    if (bytecode.empty() || !isHex(bytecode) || _entry.compare(0, pos, toHex(sha3(bytecode))) != 0)
+        return string();
+    return bytecode;
+}
+}  // namespace
+
+namespace test
+{
+LLLCompiler& LLLCompiler::get()
+{
+    static LLLCompiler instance(
+        getTestPath() / "Retesteth" / "lllcCache", Options::get().lllcCache);
+    return instance;
+}
+
+LLLCompiler::LLLCompiler(fs::path const& _cachePath, bool _useDiskCache)
+  : m_cachePath(_cachePath), m_useDiskCache(_useDiskCache)
+{}
+
+LLLCompiler::~LLLCompiler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_queueUpdate.notify_all();
+    for (auto& th : m_threads)
+        th.join();
+}
+
+string const& LLLCompiler::lllcVersion()
+{
+    std::call_once(m_versionFlag, [this]() {
+        if (runCommand("lllc --version", m_version) != 0)
+            m_version.clear();
+    });
+    return m_version;
+}
+
+LLLCompiler::Result LLLCompiler::compileCached(string const& _code)
+{
+    // The bytecode of an unknown lllc version is not kept
+    fs::path entry;
+    if (m_useDiskCache && !lllcVersion().empty())
+    {
+        entry = m_cachePath / (toHex(sha3(lllcVersion() + '\0' + _code)) + ".hex");
+        boost::system::error_code ec;
+        if (fs::exists(entry, ec))
+        {
+            Result cached;
+            cached.bytecode = readCacheEntry(contentsString(entry));
+            if (!cached.bytecode.empty())
+                return cached;
+        }
+    }
+
+    Result result;
+#if defined(_WIN32)
+    result.error = "LLL compilation only supported on posix systems.";
+#else
+    fs::path const source(fs::temp_directory_path() / fs::unique_path());
+    string const command = "lllc " + source.string();
+    try
+    {
+        writeFile(source, bytesConstRef(_code));
+    }
+    catch (std::exception const& _ex)
+    {
+        result.error = "Failed to run " + command + ": " + _ex.what();
+        return result;
+    }
+    int const exitCode = runCommand(command, result.bytecode);
+    boost::system::error_code ec;
+    fs::remove_all(source, ec);
+
+    if (exitCode == -1)
+        result.error = "Failed to run " + command;
+    else if (exitCode != 0)
+        result.error = "The command '" + command + "' exited with " + toString(exitCode) + " code.";
+    else if (result.bytecode.empty())
+        result.error = "Reading empty result for " + command;
+    else if (!entry.empty())
+    {
+        // Written to a unique file next to the entry and renamed
+        try
+        {
+            writeFile(entry, asBytes(makeCacheEntry(result.bytecode)), true);
+        }
+        catch (std::exception const&)
+        {
+            // the cache is optional
+        }
+    }
+#endif
+    return result;
+}
+
+std::shared_future<LLLCompiler::Result> LLLCompiler::enqueue(string const& _code)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const it = m_compiled.find(_code);
+    if (it != m_compiled.end())
+        return it->second;
+
+    Task task([this, _code]() { return compileCached(_code); });
+    std::shared_future<Result> result = task.get_future().share();
+    m_compiled[_code] = result;
+    m_queue.push_back({_code, std::move(task)});
+    if (m_threads.empty())
+    {
+        // lllc runs as a process of its own, one per core keeps the machine busy
+        size_t const threadCount = max(std::thread::hardware_concurrency(), 1u);
+        for (size_t i = 0; i < threadCount; i++)
+            m_threads.push_back(thread(&LLLCompiler::compileQueued, this));
+    }
+    m_queueUpdate.notify_one();
+    return result;
+}
+
+void LLLCompiler::prefetch(string const& _code)
+{
+    if (isLLL(_code))
+        enqueue(_code);
+}
+
+void LLLCompiler::prefetchFiller(DataObject const& _filler)
+{
+    for (auto const& test : _filler.getSubObjects())
+    {
+        if (test.type() != DataType::Object || !test.count("pre"))
+            continue;
+        for (auto const& account : test.at("pre").getSubObjects())
+        {
+            if (account.type() == DataType::Object && account.count("code") &&
+                account.at("code").type() == DataType::String)
+                prefetch(account.at("code").asString());
+        }
+    }
+}
+
+string LLLCompiler::compile(string const& _code)
+{
+    std::shared_future<Result> result = enqueue(_code);
+
+    // The code is needed now, it does not wait behind the code of the next tests
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto const queued = std::find_if(m_queue.begin(), m_queue.end(),
+            [&_code](std::pair<string, Task> const& _item) { return _item.first == _code; });
+        if (queued != m_queue.end())
+        {
+            task = std::move(queued->second);
+            m_queue.erase(queued);
+        }
+    }
+    if (task.valid())
+        task();
+
+    Result const& compiled = result.get();
+    ETH_CHECK_MESSAGE(compiled.error.empty(), compiled.error);
+    return "0x" + compiled.bytecode;
+}
+
+void LLLCompiler::compileQueued()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_queueUpdate.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_stop)
+            return;
+        Task task = std::move(m_queue.front().second);
+        m_queue.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+}  // namespace test
@@ -0,0 +1,90 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Compile LLL code ahead of the execution and keep the bytecode between runs
+ */
+
+#pragma once
+#include <retesteth/DataObject.h>
+#include <boost/filesystem/path.hpp>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace test
+{
+/// Compiles LLL code with lllc on background threads. Code is compiled once per process, the
+/// bytecode is kept in <testpath>/Retesteth/lllcCache under the hash of the lllc version and
+/// the source, so the next runs do not call lllc for unchanged code. An entry keeps the hash
+/// of the bytecode too, entries that do not match it are compiled again.
+class LLLCompiler
+{
+public:
+    static LLLCompiler& get();
+
+    /// Keep the bytecode in _cachePath if _useDiskCache is set
+    LLLCompiler(boost::filesystem::path const& _cachePath, bool _useDiskCache);
+    ~LLLCompiler();
+
+    /// Start compiling _code on a compiler thread unless it is compiled already.
+    /// Hex and empty code is not LLL and is ignored.
+    void prefetch(std::string const& _code);
+
+    /// Start compiling the code of the pre state accounts of every test in _filler
+    void prefetchFiller(DataObject const& _filler);
+
+    /// 0x prefixed bytecode of _code. Waits for the compiler thread if _code is being compiled,
+    /// compiles it on this thread if it is still queued or was not prefetched.
+    /// lllc errors are reported here, on the thread of the test.
+    std::string compile(std::string const& _code);
+
+private:
+    LLLCompiler(LLLCompiler const&) = delete;
+
+    struct Result
+    {
+        std::string bytecode;  ///< hex without 0x
+        std::string error;     ///< empty if lllc succeeded
+    };
+    typedef std::packaged_task<Result()> Task;
+
+    /// Queue _code unless it is known. Returns the result of _code
+    std::shared_future<Result> enqueue(std::string const& _code);
+    Result compileCached(std::string const& _code);
+    std::string const& lllcVersion();
+    void compileQueued();
+
+    boost::filesystem::path const m_cachePath;
+    bool const m_useDiskCache;
+    std::once_flag m_versionFlag;
+    std::string m_version;  ///< output of lllc --version, empty if it failed
+
+    std::mutex m_mutex;
+    std::map<std::string, std::shared_future<Result>> m_compiled;  ///< by source code
+    std::deque<std::pair<std::string, Task>> m_queue;
+    std::condition_variable m_queueUpdate;
+    std::vector<std::thread> m_threads;  ///< started with the first queued code
+    bool m_stop = false;
+};
+
+}  // namespace test
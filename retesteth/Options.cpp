@@ -40,6 +40,9 @@ void printHelp()
 	cout << setw(30) <<	"-t <TestSuite>" << setw(25) << "Execute test operations\n";
 	cout << setw(30) << "-t <TestSuite>/<TestCase>\n";
 	cout << setw(30) << "--testpath <PathToTheTestRepo>\n";
+	cout << setw(30) << "--cachesize <MB>" << setw(25) << "Memory for parsed test files (default 512, 0 disables)\n";
+	cout << setw(30) << "--nobincache" << setw(25) << "Do not keep parsed test files in <testpath>/Retesteth/binaryCache\n";
+	cout << setw(30) << "--nolllccache" << setw(25) << "Do not keep compiled LLL code in <testpath>/Retesteth/lllcCache\n";
 
 	cout << "\nDebugging\n";
 	cout << setw(30) << "-d <index>" << setw(25) << "Set the transaction data array index when running GeneralStateTests\n";
@@ -55,6 +58,14 @@ void printHelp()
 	cout << setw(30) << "--exectimelog" << setw(25) << "Output execution time for each test suite\n";
 	cout << setw(30) << "--statediff" << setw(25) << "Trace state difference for state tests\n";
 
+	cout << "\nSharding\n";
+	cout << setw(30) << "--shard <i>/<N>" << setw(25) << "Run only the i-th of N deterministic parts of the test suite\n";
+	cout << setw(30) << "--shardtimes <PathTo.json>" << setw(25) << "Use timing history (a shard result file) to balance the shards\n";
+	cout << setw(30) << "--shardresult <PathTo.json>" << setw(25) << "Write executed tests with their time and errors to the file\n";
+	cout << setw(30) << "--mergeshards <file1,file2>" << setw(25) << "Combine shard result files into --shardresult file and exit\n";
+	cout << setw(30) << "--coordinator <port>" << setw(25) << "Serve the tests to worker processes instead of running them\n";
+	cout << setw(30) << "--worker <ip:port>" << setw(25) << "Run the tests served by the coordinator on local clients\n";
+
 	cout << "\nAdditional Tests\n";
 	cout << setw(30) << "--all" << setw(25) << "Enable all tests\n";
 
@@ -190,6 +201,15 @@ Options::Options(int argc, const char** argv)
 		}
 		else if (arg == "--exectimelog")
 			exectimelog = true;
+		else if (arg == "--cachesize")
+		{
+			throwIfNoArgumentFollows();
+			testCacheSize = max(0, atoi(argv[++i]));
+		}
+		else if (arg == "--nobincache")
+			binaryCache = false;
+		else if (arg == "--nolllccache")
+			lllcCache = false;
 		else if (arg == "--all")
 			all = true;
 		else if (arg == "--singletest")
@@ -336,6 +356,53 @@ Options::Options(int argc, const char** argv)
                     clients.push_back(it);
             }
         }
+        else if (arg == "--shard")
+        {
+            throwIfNoArgumentFollows();
+            string const shard = argv[++i];
+            size_t const pos = shard.find('/');
+            if (pos == string::npos)
+                BOOST_THROW_EXCEPTION(InvalidOption("--shard expects <i>/<N>, got: " + shard));
+            int const index = atoi(shard.substr(0, pos).c_str());
+            int const count = atoi(shard.substr(pos + 1).c_str());
+            if (count < 1 || index < 1 || index > count)
+                BOOST_THROW_EXCEPTION(
+                    InvalidOption("--shard index must be in range 1..N, got: " + shard));
+            shardIndex = index - 1;
+            shardCount = count;
+        }
+        else if (arg == "--shardtimes")
+        {
+            throwIfNoArgumentFollows();
+            shardTimesFile = boost::filesystem::path(argv[++i]);
+            if (!boost::filesystem::exists(shardTimesFile.get()))
+                BOOST_THROW_EXCEPTION(InvalidOption(
+                    "--shardtimes file not found: " + shardTimesFile.get().string()));
+        }
+        else if (arg == "--shardresult")
+        {
+            throwIfNoArgumentFollows();
+            shardResultFile = boost::filesystem::path(argv[++i]);
+        }
+        else if (arg == "--mergeshards")
+        {
+            throwIfNoArgumentFollows();
+            string const files = argv[++i];
+            boost::split(mergeShardFiles, files, boost::is_any_of(","));
+        }
+        else if (arg == "--coordinator")
+        {
+            throwIfNoArgumentFollows();
+            int const port = atoi(argv[++i]);
+            if (port <= 0 || port > 65535)
+                BOOST_THROW_EXCEPTION(InvalidOption("--coordinator expects a tcp port number"));
+            coordinatorPort = port;
+        }
+        else if (arg == "--worker")
+        {
+            throwIfNoArgumentFollows();
+            workerAddress = argv[++i];
+        }
         else if (seenSeparator)
 		{
 			cerr << "Unknown option: " + arg << "\n";
@@ -361,6 +428,9 @@ Options::Options(int argc, const char** argv)
 			BOOST_THROW_EXCEPTION(InvalidOption("--seed <uint> could be used only with --createRandomTest \n"));
 	}
 
+	if (coordinatorPort && !workerAddress.empty())
+		BOOST_THROW_EXCEPTION(InvalidOption("--coordinator and --worker could not be used together"));
+
 	//Default option
     if (logVerbosity == 1)
 		g_logVerbosity = -1;	//disable cnote but leave cerr and cout
@@ -405,7 +475,7 @@ std::vector<ClientConfig> const& Options::DynamicOptions::getClientConfigs()
             fs::path configFilePath = configPath / "config";
             ETH_REQUIRE_MESSAGE(fs::exists(configFilePath),
                 string("Client config not found: ") + configFilePath.c_str());
-            ClientConfig cfg(test::convertJsonCPPtoData(readJson(configFilePath)), id++,
+            ClientConfig cfg(test::readJsonData(configFilePath), id++,
                 configPath / string(clientName + ".sh"));
             m_clientConfigs.push_back(cfg);
         }
@@ -32,6 +32,9 @@ public:
     };
 
     size_t threadCount = 1;	///< Execute tests on threads
+    size_t testCacheSize = 512;  ///< Memory for parsed test files in MB (0 disables the cache)
+    bool binaryCache = true;     ///< Keep parsed test files in <testpath>/Retesteth/binaryCache
+    bool lllcCache = true;       ///< Keep compiled LLL code in <testpath>/Retesteth/lllcCache
 	bool enableClientsOutput = false; ///< Enable stderr from clients
 	bool vmtrace = false;	///< Create EVM execution tracer
 	bool filltests = false; ///< Create JSON test files from execution results
@@ -65,6 +68,17 @@ public:
 	bool nonetwork = false;///< For libp2p
 	/// @}
 
+    /// Split tests between several machines
+    /// @{
+    size_t shardIndex = 0;  ///< Zero based index of this shard
+    size_t shardCount = 1;  ///< Number of shards. 1 means no sharding
+    boost::optional<boost::filesystem::path> shardTimesFile;   ///< Timing history for balancing
+    boost::optional<boost::filesystem::path> shardResultFile;  ///< Output executed tests
+    std::vector<std::string> mergeShardFiles;  ///< Shard result files to combine into one report
+    unsigned short coordinatorPort = 0;  ///< Serve tests to the workers on this port
+    std::string workerAddress;           ///< Take tests from the coordinator at this <ip:port>
+    /// @}
+
 	/// Get reference to options
 	/// The first time used, options are parsed with argc, argv
 	static Options const& get(int argc = 0, const char** argv = 0);
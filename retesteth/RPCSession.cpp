@@ -30,6 +30,7 @@
 #include <cstdio>
 #include <mutex>
 #include <csignal>
+#include <atomic>
 
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
@@ -54,16 +55,53 @@ struct sessionInfo
     std::unique_ptr<RPCSession> session;
     std::unique_ptr<FILE> filePipe;
     int pipePid;
-    RPCSession::SessionStatus isUsed;
+    std::atomic<RPCSession::SessionStatus> isUsed;  // written by the owner, polled by joinThreads
     std::string tmpDir;
     unsigned configId;
 };
 
-void closeSession(const string& _threadID);
+namespace
+{
+// Every started client is owned by the pool. A test thread borrows a session from the free list
+// of the current config and keeps the handle in thread local storage, so the calls made while
+// the test runs do not touch the pool. The pool mutex is only taken to lend and return sessions.
+std::mutex g_sessionPoolMutex;
+std::vector<std::unique_ptr<sessionInfo>> g_sessions;
+std::map<unsigned, std::vector<sessionInfo*>> g_freeSessions;  // config id => available sessions
+std::map<std::string, sessionInfo*> g_lentSessions;            // thread id => borrowed session
+
+// Handles of the previous generation refer to the sessions destroyed by clear()
+std::atomic<unsigned> g_poolGeneration(0);
+struct SessionHandle
+{
+    sessionInfo* info = nullptr;
+    unsigned generation = 0;
+    std::string threadID;
+};
+thread_local SessionHandle t_session;
+
+sessionInfo* borrowedSession(std::string const& _threadID)
+{
+    if (t_session.info && t_session.generation == g_poolGeneration &&
+        t_session.threadID == _threadID)
+        return t_session.info;
+    return nullptr;
+}
+
+void closeSession(sessionInfo* _element)
+{
+    if (_element->session.get()->getSocketType() == Socket::SocketType::IPC)
+    {
+        test::pclose2(_element->filePipe.get(), _element->pipePid);
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+        boost::filesystem::remove_all(boost::filesystem::path(_element->tmpDir));
+        _element->filePipe.release();
+        _element->session.release();
+    }
+}
+}  // namespace
 
-std::mutex g_socketMapMutex;
-static std::map<std::string, sessionInfo> socketMap;
-void RPCSession::runNewInstanceOfAClient(string const& _threadID, ClientConfig const& _config)
+std::unique_ptr<sessionInfo> RPCSession::runNewInstanceOfAClient(ClientConfig const& _config)
 {
     if (_config.getType() == Socket::IPC)
     {
@@ -95,118 +133,146 @@ void RPCSession::runNewInstanceOfAClient(string const& _threadID, ClientConfig c
             // Client has opened ipc socket. wait for it to initialize
             std::this_thread::sleep_for(std::chrono::seconds(4));
         }
-        // sessionInfo info(fp,
-        //    new RPCSession(Socket::SocketType::IPC, "/home/wins/.ethereum/geth.ipc"),
-        //    tmpDir.string(), pid, _config.getId());
-        sessionInfo info(fp, new RPCSession(Socket::SocketType::IPC, ipcPath), tmpDir.string(), pid,
-            _config.getId());
-        {
-            std::lock_guard<std::mutex> lock(
-                g_socketMapMutex);  // function must be called from lock
-            socketMap.insert(std::pair<string, sessionInfo>(_threadID, std::move(info)));
-        }
+        return std::unique_ptr<sessionInfo>(
+            new sessionInfo(fp, new RPCSession(Socket::SocketType::IPC, ipcPath),
+                tmpDir.string(), pid, _config.getId()));
     }
     else if (_config.getType() == Socket::TCP)
     {
-        sessionInfo info(NULL, new RPCSession(Socket::SocketType::TCP, _config.getAddress()), "", 0,
-            _config.getId());
-        {
-            std::lock_guard<std::mutex> lock(
-                g_socketMapMutex);  // function must be called from lock
-            socketMap.insert(std::pair<string, sessionInfo>(_threadID, std::move(info)));
-        }
+        return std::unique_ptr<sessionInfo>(new sessionInfo(NULL,
+            new RPCSession(Socket::SocketType::TCP, _config.getAddress()), "", 0,
+            _config.getId()));
     }
-    else
-        ETH_FAIL("Unknown Socket Type in runNewInstanceOfAClient");
+    ETH_FAIL("Unknown Socket Type in runNewInstanceOfAClient");
+    return std::unique_ptr<sessionInfo>();
 }
 
 RPCSession& RPCSession::instance(const string& _threadID)
 {
-    bool needToCreateNew = false;
+    unsigned currentConfigId = Options::getDynamicOptions().getCurrentConfig().getId();
+    if (sessionInfo* borrowed = borrowedSession(_threadID))
     {
-        std::lock_guard<std::mutex> lock(g_socketMapMutex);
-        unsigned currentConfigId = Options::getDynamicOptions().getCurrentConfig().getId();
-        if (socketMap.count(_threadID) && socketMap.at(_threadID).configId != currentConfigId)
-        {
-            // For this thread a session is opened but it is opened not for current tested client
+        // For this thread a session is opened but it is opened not for current tested client
+        if (borrowed->configId != currentConfigId)
             ETH_FAIL("A session opened for another client id!");
-        }
+        return *borrowed->session.get();
+    }
 
-        if (!socketMap.count(_threadID))
+    sessionInfo* info = nullptr;
+    unsigned generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+        auto const lent = g_lentSessions.find(_threadID);
+        if (lent != g_lentSessions.end())
+        {
+            // Borrowed by a thread with the same id that did not return it, or asked from another
+            // thread. Either way the session stays with this thread id
+            if (lent->second->configId != currentConfigId)
+                ETH_FAIL("A session opened for another client id!");
+            info = lent->second;
+        }
+        else
         {
             // look for free clients that already instantiated
-            for (auto& socket : socketMap)
+            std::vector<sessionInfo*>& freeList = g_freeSessions[currentConfigId];
+            if (!freeList.empty())
             {
-                if (socket.second.isUsed == SessionStatus::Available)
-                    if (socket.second.configId == currentConfigId)
-                    {
-                        socket.second.isUsed = SessionStatus::Working;
-                        socketMap.insert(
-                            std::pair<string, sessionInfo>(_threadID, std::move(socket.second)));
-                        socketMap.erase(socketMap.find(socket.first));  // remove previous threadID
-                                                                        // assigment to this socket
-                        return *(socketMap.at(_threadID).session.get());
-                }
+                info = freeList.back();
+                freeList.pop_back();
+                info->isUsed = SessionStatus::Working;
+                g_lentSessions[_threadID] = info;
             }
-            needToCreateNew = true;
         }
+        generation = g_poolGeneration;
+    }
+
+    if (!info)
+    {
+        // Start the client outside of the lock, other threads could borrow meanwhile
+        std::unique_ptr<sessionInfo> newSession =
+            runNewInstanceOfAClient(Options::getDynamicOptions().getCurrentConfig());
+        std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+        info = newSession.get();
+        g_sessions.push_back(std::move(newSession));
+        g_lentSessions[_threadID] = info;
+        generation = g_poolGeneration;
+        ETH_REQUIRE_MESSAGE(g_sessions.size() <= Options::get().threadCount,
+            "Something went wrong. Retesteth create more instances than needed!");
     }
-    if (needToCreateNew)
-        runNewInstanceOfAClient(_threadID, Options::getDynamicOptions().getCurrentConfig());
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    ETH_REQUIRE_MESSAGE(socketMap.size() <= Options::get().threadCount,
-        "Something went wrong. Retesteth create more instances than needed!");
-    return *(socketMap.at(_threadID).session.get());
+
+    if (_threadID == TestOutputHelper::getThreadID())
+    {
+        t_session.info = info;
+        t_session.generation = generation;
+        t_session.threadID = _threadID;
+    }
+    return *info->session.get();
 }
 
 void RPCSession::sessionStart(std::string const& _threadID)
 {
     RPCSession::instance(_threadID);  // initialize the client if not exist
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    if (socketMap.count(_threadID))
-        socketMap.at(_threadID).isUsed = SessionStatus::Working;
+    if (sessionInfo* borrowed = borrowedSession(_threadID))
+    {
+        borrowed->isUsed = SessionStatus::Working;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+    if (g_lentSessions.count(_threadID))
+        g_lentSessions.at(_threadID)->isUsed = SessionStatus::Working;
 }
 
 void RPCSession::sessionEnd(std::string const& _threadID, SessionStatus _status)
 {
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    assert(socketMap.count(_threadID));
-    if (socketMap.count(_threadID))
-        socketMap.at(_threadID).isUsed = _status;
+    // The test thread reports that it has finished without locking the pool
+    if (_status != SessionStatus::Available)
+        if (sessionInfo* borrowed = borrowedSession(_threadID))
+        {
+            borrowed->isUsed = _status;
+            return;
+        }
+
+    std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+    auto const lent = g_lentSessions.find(_threadID);
+    assert(lent != g_lentSessions.end());
+    if (lent == g_lentSessions.end())
+        return;
+    sessionInfo* info = lent->second;
+    info->isUsed = _status;
+    if (_status == SessionStatus::Available)
+    {
+        // The thread is joined. Give the session back to the pool
+        if (t_session.info == info)
+            t_session.info = nullptr;
+        g_lentSessions.erase(lent);
+        g_freeSessions[info->configId].push_back(info);
+    }
 }
 
 RPCSession::SessionStatus RPCSession::sessionStatus(std::string const& _threadID)
 {
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    if (socketMap.count(_threadID))
-        return socketMap.at(_threadID).isUsed;
+    if (sessionInfo* borrowed = borrowedSession(_threadID))
+        return borrowed->isUsed;
+    std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
+    auto const lent = g_lentSessions.find(_threadID);
+    if (lent != g_lentSessions.end())
+        return lent->second->isUsed;
     return RPCSession::NotExist;
 }
 
-void closeSession(const string& _threadID)
-{
-    ETH_REQUIRE_MESSAGE(socketMap.count(_threadID), "Socket map is empty in closeSession!");
-    sessionInfo& element = socketMap.at(_threadID);
-    if (element.session.get()->getSocketType() == Socket::SocketType::IPC)
-    {
-        test::pclose2(element.filePipe.get(), element.pipePid);
-        std::this_thread::sleep_for(std::chrono::seconds(4));
-        boost::filesystem::remove_all(boost::filesystem::path(element.tmpDir));
-        element.filePipe.release();
-        element.session.release();
-    }
-}
-
 void RPCSession::clear()
 {
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
+    std::lock_guard<std::mutex> lock(g_sessionPoolMutex);
     std::vector<thread> closingThreads;
-    for (auto& element : socketMap)
-        closingThreads.push_back(thread(closeSession, element.first));
+    for (auto& element : g_sessions)
+        closingThreads.push_back(thread(closeSession, element.get()));
     for (auto& th : closingThreads)
         th.join();
 
-    socketMap.clear();
+    g_poolGeneration++;
+    g_lentSessions.clear();
+    g_freeSessions.clear();
+    g_sessions.clear();
     closingThreads.clear();
 }
 
@@ -7,12 +7,14 @@
 #include <string>
 #include <stdio.h>
 #include <map>
+#include <memory>
 
 #include <libdevcore/CommonData.h>
 #include <libdevcore/Common.h>
 #include <retesteth/ethObjects/common.h>
 #include <retesteth/Socket.h>
 
+struct sessionInfo;
 class RPCSession: public boost::noncopyable
 {
 public:
@@ -36,6 +38,8 @@ public:
         NotExist      // socket yet not initialized
     };
 
+    /// Session borrowed by _threadID from the pool of started clients of the current config.
+    /// Repeated calls from the borrowing thread do not lock the pool.
     static RPCSession& instance(std::string const& _threadID);
     static void sessionStart(std::string const &_threadID);
     static void sessionEnd(std::string const& _threadID, SessionStatus _status);
@@ -81,7 +85,7 @@ public:
 
 private:
     explicit RPCSession(Socket::SocketType _type, std::string const& _path);
-    static void runNewInstanceOfAClient(std::string const& _threadID, ClientConfig const& _config);
+    static std::unique_ptr<sessionInfo> runNewInstanceOfAClient(ClientConfig const& _config);
 
     inline std::string quote(std::string const& _arg) { return "\"" + _arg + "\""; }
 	/// Parse std::string replacing keywords to values
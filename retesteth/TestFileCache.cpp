@@ -0,0 +1,123 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Cache of parsed test files
+ */
+
+#include <boost/filesystem.hpp>
+#include <retesteth/BinaryTestCache.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestFileCache.h>
+#include <retesteth/TestHelper.h>
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace test
+{
+TestFileCache& TestFileCache::get()
+{
+    static TestFileCache instance;
+    return instance;
+}
+
+TestFileCache::TestFileCache() : m_maxMemory(Options::get().testCacheSize * 1024 * 1024) {}
+
+size_t TestFileCache::memoryUsage(DataObject const& _data)
+{
+    size_t memory = sizeof(DataObject) + _data.getKey().capacity();
+    if (_data.type() == DataType::String)
+        memory += _data.asString().capacity();
+    for (auto const& obj : _data.getSubObjects())
+        memory += memoryUsage(obj);
+    return memory;
+}
+
+shared_ptr<DataObject const> TestFileCache::load(fs::path const& _file, string const& _member)
+{
+    string const key = fs::absolute(_file).string();
+    time_t const mtime = fs::last_write_time(_file);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto const it = m_entries.find(key);
+        if (it != m_entries.end() && it->second.mtime == mtime)
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+            return it->second.data;
+        }
+    }
+
+    if (!_member.empty())
+    {
+        return std::make_shared<DataObject>(readJsonData(
+            _file, [&_member](string const& _key) { return _key == _member; }));
+    }
+
+    // Parse without the lock. Two threads could parse the same file, the last one is kept
+    shared_ptr<DataObject> data = std::make_shared<DataObject>();
+    dev::h256 hash;
+    if (!BinaryTestCache::get().load(_file, *data, hash))
+    {
+        data->replace(readJsonData(_file));
+        // A file that failed to parse is read again by the next caller, which reports the error
+        if (data->type() == DataType::Null)
+            return data;
+        BinaryTestCache::get().store(_file, *data);
+    }
+    insert(key, mtime, data);
+    return data;
+}
+
+void TestFileCache::store(fs::path const& _file, DataObject&& _data)
+{
+    insert(fs::absolute(_file).string(), fs::last_write_time(_file),
+        std::make_shared<DataObject>(std::move(_data)));
+}
+
+void TestFileCache::insert(string const& _key, time_t _mtime, shared_ptr<DataObject const> _data)
+{
+    size_t const memory = memoryUsage(*_data);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const it = m_entries.find(_key);
+    if (it != m_entries.end())
+    {
+        m_usedMemory -= it->second.memory;
+        m_lru.erase(it->second.lruPosition);
+        m_entries.erase(it);
+    }
+    if (memory > m_maxMemory)
+        return;
+
+    while (m_usedMemory + memory > m_maxMemory && !m_lru.empty())
+    {
+        auto const last = m_entries.find(m_lru.back());
+        m_usedMemory -= last->second.memory;
+        m_entries.erase(last);
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(_key);
+    Entry entry;
+    entry.mtime = _mtime;
+    entry.memory = memory;
+    entry.data = _data;
+    entry.lruPosition = m_lru.begin();
+    m_entries[_key] = entry;
+    m_usedMemory += memory;
+}
+
+}  // namespace test
@@ -0,0 +1,72 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Cache of parsed test files
+ */
+
+#pragma once
+#include <retesteth/DataObject.h>
+#include <boost/filesystem/path.hpp>
+#include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace test
+{
+/// Parsed json files keyed by path and modification time. Least recently used files are
+/// dropped when the parsed data takes more than --cachesize megabytes.
+class TestFileCache
+{
+public:
+    static TestFileCache& get();
+
+    /// Parse _file or return the cached data if the file has not changed since
+    /// If _member is set and the file is not cached, only the top level member _member is
+    /// parsed, the other members are skipped. Such partial data is not cached.
+    std::shared_ptr<DataObject const> load(
+        boost::filesystem::path const& _file, std::string const& _member = std::string());
+
+    /// Remember the data that has just been written into _file
+    void store(boost::filesystem::path const& _file, DataObject&& _data);
+
+    /// Approximate memory taken by _data
+    static size_t memoryUsage(DataObject const& _data);
+
+private:
+    TestFileCache();
+    TestFileCache(TestFileCache const&) = delete;
+    void insert(std::string const& _key, std::time_t _mtime, std::shared_ptr<DataObject const> _data);
+
+    struct Entry
+    {
+        std::time_t mtime;
+        size_t memory;
+        std::shared_ptr<DataObject const> data;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    std::mutex m_mutex;
+    std::map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;  ///< most recently used first
+    size_t m_usedMemory = 0;
+    size_t m_maxMemory;
+};
+
+}  // namespace test
@@ -0,0 +1,107 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Read and parse test files ahead of the test execution
+ */
+
+#include <retesteth/TestFileLoader.h>
+#include <retesteth/TestOutputHelper.h>
+#include <algorithm>
+
+using namespace std;
+
+namespace test
+{
+TestFileLoader::TestFileLoader(vector<LoadFunction> const& _loaders, size_t _depth)
+  : m_loaders(_loaders),
+    m_results(_loaders.size()),
+    m_ready(_loaders.size(), false),
+    m_depth(max<size_t>(_depth, 1))
+{
+    size_t const threadCount = min(m_depth, m_loaders.size());
+    for (size_t i = 0; i < threadCount; i++)
+        m_threads.push_back(thread(&TestFileLoader::loadFiles, this));
+}
+
+TestFileLoader::~TestFileLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_loadUpdate.notify_all();
+    for (auto& th : m_threads)
+        th.join();
+}
+
+void TestFileLoader::loadFiles()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        // do not load more than m_depth files ahead of the consumer
+        m_loadUpdate.wait(lock, [this]() {
+            return m_stop || m_nextLoad >= m_loaders.size() ||
+                   m_nextLoad < m_nextResult + m_depth;
+        });
+        if (m_stop || m_nextLoad >= m_loaders.size())
+            return;
+        size_t const index = m_nextLoad++;
+
+        lock.unlock();
+        std::shared_ptr<TestFileData> result;
+        if (m_loaders[index])
+        {
+            // A bad file is not reported here, where the error would not belong to its test.
+            // The test thread reads the file again and reports the error.
+            TestOutputHelper& helper = TestOutputHelper::get();
+            size_t const errorCount = helper.getErrors().size();
+            try
+            {
+                result = std::make_shared<TestFileData>(m_loaders[index]());
+            }
+            catch (...)
+            {
+                result.reset();
+            }
+            bool const isNull = result && result->data.type() == DataType::Null &&
+                                (!result->test || result->test->type() == DataType::Null);
+            if (helper.getErrors().size() != errorCount || isNull)
+                result.reset();
+            helper.dropErrors(errorCount);
+        }
+        lock.lock();
+
+        m_results[index] = result;
+        m_ready[index] = true;
+        m_resultUpdate.notify_all();
+    }
+}
+
+std::shared_ptr<TestFileData> TestFileLoader::next()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_nextResult >= m_loaders.size())
+        return std::shared_ptr<TestFileData>();
+    m_resultUpdate.wait(lock, [this]() { return m_ready[m_nextResult]; });
+    std::shared_ptr<TestFileData> result;
+    result.swap(m_results[m_nextResult++]);
+    m_loadUpdate.notify_all();
+    return result;
+}
+
+}  // namespace test
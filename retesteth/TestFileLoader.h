@@ -0,0 +1,74 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Read and parse test files ahead of the test execution
+ */
+
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <retesteth/DataObject.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace test
+{
+struct TestFileData
+{
+    DataObject data;
+    dev::h256 hash;
+    /// The filled test when the tests are executed, shared with TestFileCache
+    std::shared_ptr<DataObject const> test;
+};
+
+/// Runs the load functions on background threads, at most _depth files ahead of the consumer,
+/// and gives the results away in the order of the functions.
+class TestFileLoader
+{
+public:
+    typedef std::function<TestFileData()> LoadFunction;
+
+    TestFileLoader(std::vector<LoadFunction> const& _loaders, size_t _depth);
+    ~TestFileLoader();
+
+    /// Wait for the next file. Returns nullptr if its load function is empty or has failed,
+    /// so the test could read the file by itself and report the error. A load function fails
+    /// if it throws, marks an error with ETH_ERROR or returns Null data and no Null test.
+    std::shared_ptr<TestFileData> next();
+
+private:
+    TestFileLoader(TestFileLoader const&) = delete;
+    void loadFiles();
+
+    std::vector<LoadFunction> m_loaders;
+    std::vector<std::shared_ptr<TestFileData>> m_results;
+    std::vector<bool> m_ready;
+    size_t m_nextLoad = 0;    ///< next file to be taken by a loader thread
+    size_t m_nextResult = 0;  ///< next file to be given to the consumer
+    size_t m_depth;
+    bool m_stop = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_loadUpdate;    ///< the consumer has taken a file
+    std::condition_variable m_resultUpdate;  ///< a loader has finished a file
+    std::vector<std::thread> m_threads;
+};
+
+}  // namespace test
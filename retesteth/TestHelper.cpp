@@ -9,6 +9,8 @@
 #include <fcntl.h>
 #include <mutex>
 
+#include <retesteth/JsonParser.h>
+#include <retesteth/LLLCompiler.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/Options.h>
@@ -33,6 +35,27 @@ Json::Value readJson(fs::path const& _file)
     return v;
 }
 
+DataObject readJsonData(fs::path const& _file, JsonMemberFilter const& _filter)
+{
+    string const s = dev::contentsString(_file);
+    string const fname = _file.filename().string();
+    ETH_REQUIRE_MESSAGE(s.length() > 0, "Contents of " + fname +
+                                            " is empty. Have you cloned the 'tests' repo branch "
+                                            "develop and set ETHEREUM_TEST_PATH to its path?");
+    string error;
+    dev::Timer timer;
+    DataObject data = parseJsonData(s, error, _filter);
+    if (!error.empty())
+        ETH_ERROR("Failed to parse json file\n" + error + "(" + fname + ")");
+    else if (Options::get().logVerbosity >= 6)
+    {
+        double const seconds = max(timer.elapsed(), 1e-6);
+        ETH_TEST_MESSAGE("Parsed " + fname + " (" + toString(s.size() / 1024) + " KB) at " +
+                         toString(int(s.size() / seconds / (1024 * 1024))) + " MB/s");
+    }
+    return data;
+}
+
 vector<fs::path> getFiles(
 	fs::path const& _dirPath, set<string> const _extentionMask, string const& _particularFile)
 {
@@ -76,6 +99,22 @@ boost::filesystem::path getTestPath()
 	return boost::filesystem::path(testPath);
 }
 
+void writeJsonFile(fs::path const& _file, DataObject const& _data)
+{
+    // The stream buffer is reused by every file written on this thread
+    static thread_local vector<char> buffer(1024 * 1024);
+    if (!_file.parent_path().empty() && !fs::exists(_file.parent_path()))
+        fs::create_directories(_file.parent_path());
+
+    fs::ofstream out;
+    out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    out.open(_file, ios::trunc | ios::binary);
+    _data.asJson(out);
+    out.close();
+    ETH_REQUIRE_MESSAGE(!out.fail(), "Could not write to file: " + _file.string());
+    DEV_IGNORE_EXCEPTIONS(fs::permissions(_file, fs::owner_read | fs::owner_write));
+}
+
 void copyFile(fs::path const& _source, fs::path const& _destination)
 {
 	fs::ifstream src(_source, ios::binary);
@@ -133,12 +172,8 @@ DataObject convertJsonCPPtoData(Json::Value const& _input)
 	if (_input.isObject())
 	{
 		DataObject root(DataType::Object);
-		for (auto const& i: _input)
-			root.addSubObject(convertJsonCPPtoData(i));
-
-		size_t index = 0;
 		for (auto const& i: _input.getMemberNames())
-			root.setSubObjectKey(index++, i);
+			root.addSubObject(i, convertJsonCPPtoData(_input[i]));
 		return root;
 	}
 
@@ -348,12 +383,7 @@ string compileLLL(string const& _code)
 	BOOST_ERROR("LLL compilation only supported on posix systems.");
 	return "";
 #else
-	fs::path path(fs::temp_directory_path() / fs::unique_path());
-	string cmd = string("lllc ") + path.string();
-	writeFile(path.string(), _code);
-	string result = executeCmd(cmd);
-	fs::remove_all(path);
-	result = "0x" + result;
+	string result = LLLCompiler::get().compile(_code);
 	checkHexHasEvenLength(result);
 	return result;
 #endif
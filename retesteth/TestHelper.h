@@ -7,6 +7,7 @@
 
 #include <retesteth/EthChecks.h>
 #include <retesteth/DataObject.h>
+#include <retesteth/JsonParser.h>
 
 namespace fs = boost::filesystem;
 namespace test {
@@ -28,6 +29,13 @@ void copyFile(fs::path const& _source, fs::path const& _destination);
 /// Read Json Object into DataObject
 DataObject convertJsonCPPtoData(Json::Value const& _input);
 
+/// Read json file straight into DataObject (same result as convertJsonCPPtoData(readJson()))
+/// Only the top level members accepted by _filter are built if it is set
+DataObject readJsonData(fs::path const& _file, JsonMemberFilter const& _filter = JsonMemberFilter());
+
+/// Stream DataObject into a json file without making a string copy of the document
+void writeJsonFile(fs::path const& _file, DataObject const& _data);
+
 /// Get Networks / Fork Rules
 std::vector<std::string> const& getNetworks();
 
@@ -18,6 +18,8 @@
  * Fixture class for boost output when running testeth
  */
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <boost/test/unit_test.hpp>
@@ -34,21 +36,28 @@ using namespace boost;
 
 typedef std::pair<double, std::string> execTimeName;
 static std::vector<execTimeName> execTimeResults;
-static std::map<std::string, TestOutputHelper> helperThreadMap; // threadID => outputHelper
-
-mutex g_helperThreadMapMutex;
+static size_t importedBlocks = 0;
+static u256 importedGas = 0;
+static double importTime = 0;
+
+// Each thread keeps a pointer to its own helper, so get() does not lock. The helpers are owned by
+// helperThreads and outlive their threads until the errors are collected by printBoostError.
+static std::vector<std::unique_ptr<TestOutputHelper>> helperThreads;
+static std::atomic<unsigned> helperGeneration(0);  // helpers of older generations are destroyed
+mutex g_helperThreadsMutex;
 TestOutputHelper& TestOutputHelper::get()
 {
-    std::lock_guard<std::mutex> lock(g_helperThreadMapMutex);
-    if (helperThreadMap.count(getThreadID()))
-        return helperThreadMap.at(getThreadID());
-    else
-    {
-        TestOutputHelper instance;
-        helperThreadMap.emplace(std::make_pair(getThreadID(), std::move(instance)));
-        helperThreadMap.at(getThreadID()).initTest(0);
-    }
-    return helperThreadMap.at(getThreadID());
+    static thread_local TestOutputHelper* helper = nullptr;
+    static thread_local unsigned generation = 0;
+    if (helper && generation == helperGeneration)
+        return *helper;
+
+    std::lock_guard<std::mutex> lock(g_helperThreadsMutex);
+    helperThreads.push_back(std::unique_ptr<TestOutputHelper>(new TestOutputHelper()));
+    helper = helperThreads.back().get();
+    generation = helperGeneration;
+    helper->initTest(0);
+    return *helper;
 }
 
 void TestOutputHelper::initTest(size_t _maxTests)
@@ -106,11 +115,18 @@ void TestOutputHelper::finishTest()
 
 void TestOutputHelper::printBoostError()
 {
+    // Merge the errors of all threads. Test threads are joined at this point
+    std::vector<std::unique_ptr<TestOutputHelper>> helpers;
+    {
+        std::lock_guard<std::mutex> lock(g_helperThreadsMutex);
+        helpers.swap(helperThreads);
+    }
+
     size_t errorCount = 0;
-    for (auto const& test: helperThreadMap)
+    for (auto const& test: helpers)
     {
-        errorCount += test.second.getErrors().size();
-        for (auto const& a : test.second.getErrors())
+        errorCount += test->getErrors().size();
+        for (auto const& a : test->getErrors())
             ETH_ERROR_MESSAGE("Error: " + a);
     }
     if (errorCount)
@@ -119,7 +135,9 @@ void TestOutputHelper::printBoostError()
             "TestOutputHelper detected " + toString(errorCount) + " errors during test execution!");
         BOOST_ERROR("");  // NOT THREAD SAFE !!!
     }
-    helperThreadMap.clear();
+
+    // The helpers are destroyed on return, every thread gets a new one on next get()
+    helperGeneration++;
 }
 
 void TestOutputHelper::printTestExecStats()
@@ -135,12 +153,33 @@ void TestOutputHelper::printTestExecStats()
         std::cout << setw(45) << "Total Time: " << setw(25) << "     : " + toString(totalTime) << "\n";
         for (size_t i = 0; i < execTimeResults.size(); i++)
             std::cout << setw(45) << execTimeResults[i].second << setw(25) << " time: " + toString(execTimeResults[i].first) << "\n";
+        if (importedBlocks)
+        {
+            double const mgas = importedGas.convert_to<double>() / 1000000;
+            std::cout << "Imported blocks: " << importedBlocks << ", gas: " << importedGas
+                      << ", time: " << importTime << ", Mgas/s: " << mgas / std::max(importTime, 1e-9)
+                      << "\n";
+        }
 	}
     execTimeResults.clear();
+    importedBlocks = 0;
+    importedGas = 0;
+    importTime = 0;
+}
+
+void TestOutputHelper::registerBlockImport(u256 const& _gasUsed, double _seconds)
+{
+    if (!Options::get().exectimelog)
+        return;
+    std::lock_guard<std::mutex> lock(g_resultsUpdate_mutex);
+    importedBlocks++;
+    importedGas += _gasUsed;
+    importTime += _seconds;
 }
 
-std::string TestOutputHelper::getThreadID()
+std::string const& TestOutputHelper::getThreadID()
 {
-    return toString(std::this_thread::get_id());
+    static thread_local std::string const threadID = toString(std::this_thread::get_id());
+    return threadID;
 }
 
@@ -43,15 +43,23 @@ public:
 	bool checkTest(std::string const& _testName);
     void markError(std::string const& _message) { m_errors.push_back(_message); }
     std::vector<std::string> const& getErrors() const { return m_errors;}
+    /// Forget the errors marked after the first _count ones
+    void dropErrors(size_t _count)
+    {
+        if (_count < m_errors.size())
+            m_errors.resize(_count);
+    }
     void setCurrentTestFile(boost::filesystem::path const& _name) { m_currentTestFileName = _name; }
 	void setCurrentTestName(std::string const& _name) { m_currentTestName = _name; }
 	std::string const& testName() { return m_currentTestName; }
 	std::string const& caseName() { return m_currentTestCaseName; }
 	boost::filesystem::path const& testFile() { return m_currentTestFileName; }
         static void printTestExecStats();
+        /// Count a block imported by the client for the --exectimelog throughput
+        static void registerBlockImport(dev::u256 const& _gasUsed, double _seconds);
 
         /// get string representation of current threadID
-        static std::string getThreadID();
+        static std::string const& getThreadID();
 
       private:
 	TestOutputHelper() {}
@@ -0,0 +1,237 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Split the test suite between several machines (--shard i/N)
+ */
+
+#include <json/reader.h>
+#include <json/writer.h>
+#include <libdevcore/CommonIO.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/TestSharding.h>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace
+{
+/// FNV-1a. Unlike std::hash it gives the same value on every platform and compiler
+uint64_t stableHash(string const& _name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : _name)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+}  // namespace
+
+namespace test
+{
+TestSharding& TestSharding::get()
+{
+    static TestSharding instance;
+    return instance;
+}
+
+TestSharding::TestSharding()
+{
+    if (Options::get().shardTimesFile.is_initialized())
+        loadTimingHistory(Options::get().shardTimesFile.get());
+}
+
+bool TestSharding::isEnabled() const
+{
+    return Options::get().shardCount > 1;
+}
+
+void TestSharding::loadTimingHistory(fs::path const& _file)
+{
+    // The history uses the format of --shardresult file, so a merged report of the previous run
+    // could be passed here directly
+    Json::Value const history = readJson(_file);
+    ETH_REQUIRE_MESSAGE(history.isObject() && history.isMember("tests"),
+        "Shard timing file must contain 'tests' section: " + _file.string());
+    Json::Value const& tests = history["tests"];
+    for (auto const& name : tests.getMemberNames())
+        if (tests[name].isMember("time"))
+            m_timingHistory[name] = tests[name]["time"].asDouble();
+}
+
+set<string> TestSharding::selectShard(vector<string> const& _names) const
+{
+    set<string> selected;
+    Options const& opt = Options::get();
+    if (!isEnabled())
+    {
+        selected.insert(_names.begin(), _names.end());
+        return selected;
+    }
+
+    // Sort the names so that the partition does not depend on the directory listing order
+    vector<string> names = _names;
+    sort(names.begin(), names.end());
+    names.erase(unique(names.begin(), names.end()), names.end());
+
+    double knownTime = 0;
+    size_t knownCount = 0;
+    for (auto const& name : names)
+    {
+        auto const it = m_timingHistory.find(name);
+        if (it != m_timingHistory.end())
+        {
+            knownTime += it->second;
+            knownCount++;
+        }
+    }
+
+    if (knownCount == 0)
+    {
+        for (auto const& name : names)
+            if (stableHash(name) % opt.shardCount == opt.shardIndex)
+                selected.insert(name);
+        return selected;
+    }
+
+    // Longest processing time first: take the most expensive test and put it into the least
+    // loaded bin. New tests without history are assumed to take an average time.
+    double const averageTime = knownTime / knownCount;
+    vector<pair<double, string>> costs;
+    for (auto const& name : names)
+    {
+        auto const it = m_timingHistory.find(name);
+        costs.push_back({it != m_timingHistory.end() ? it->second : averageTime, name});
+    }
+    stable_sort(costs.begin(), costs.end(),
+        [](pair<double, string> const& _a, pair<double, string> const& _b) {
+            return _a.first > _b.first;
+        });
+
+    vector<double> binLoad(opt.shardCount, 0);
+    for (auto const& cost : costs)
+    {
+        size_t const bin = min_element(binLoad.begin(), binLoad.end()) - binLoad.begin();
+        binLoad[bin] += cost.first;
+        if (bin == opt.shardIndex)
+            selected.insert(cost.second);
+    }
+    return selected;
+}
+
+void TestSharding::registerResult(
+    string const& _name, double _time, vector<string> const& _errors)
+{
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    TestResult& res = m_results[_name];
+    res.time += _time;
+    res.errors.insert(res.errors.end(), _errors.begin(), _errors.end());
+}
+
+void TestSharding::writeResults() const
+{
+    Options const& opt = Options::get();
+    if (!opt.shardResultFile.is_initialized())
+        return;
+
+    Json::Value output(Json::objectValue);
+    output["shard"] = toString(opt.shardIndex + 1) + "/" + toString(opt.shardCount);
+    output["tests"] = Json::Value(Json::objectValue);
+    for (auto const& res : m_results)
+    {
+        Json::Value test(Json::objectValue);
+        test["time"] = res.second.time;
+        test["errors"] = Json::Value(Json::arrayValue);
+        for (auto const& error : res.second.errors)
+            test["errors"].append(error);
+        output["tests"][res.first] = test;
+    }
+    dev::writeFile(opt.shardResultFile.get(), dev::asBytes(Json::StyledWriter().write(output)));
+}
+
+size_t TestSharding::mergeResults(vector<string> const& _files, fs::path const& _output)
+{
+    // Merging runs before the unit test framework is initialized, so nothing here may go
+    // through TestOutputHelper. The errors are printed and counted as failures instead.
+    Json::Value merged(Json::objectValue);
+    merged["shard"] = "merged";
+    merged["tests"] = Json::Value(Json::objectValue);
+    Json::Value& tests = merged["tests"];
+
+    double totalTime = 0;
+    size_t failures = 0;
+    set<string> shards;
+    for (auto const& file : _files)
+    {
+        Json::Value shardResult;
+        string const contents = dev::contentsString(file);
+        if (!Json::Reader().parse(contents, shardResult) || !shardResult.isObject() ||
+            !shardResult.isMember("shard") || !shardResult["tests"].isObject())
+        {
+            std::cerr << "Not a shard result file: " << file << std::endl;
+            failures++;
+            continue;
+        }
+        string const shard = shardResult["shard"].asString();
+        if (shards.count(shard))
+        {
+            std::cerr << "Shard " << shard << " is given twice: " << file << std::endl;
+            failures++;
+            continue;
+        }
+        shards.emplace(shard);
+
+        Json::Value const& shardTests = shardResult["tests"];
+        for (auto const& name : shardTests.getMemberNames())
+        {
+            Json::Value const& test = shardTests[name];
+            if (tests.isMember(name))
+            {
+                // The first result is kept, the test is failed in the merged report
+                string const error = "Test was executed by more than one shard! (" +
+                                     tests[name]["shard"].asString() + ", " + shard + ")";
+                std::cerr << name << ": " << error << std::endl;
+                tests[name]["errors"].append(error);
+                totalTime += test["time"].asDouble();
+                failures++;
+                continue;
+            }
+            tests[name] = test;
+            tests[name]["shard"] = shard;
+            totalTime += test["time"].asDouble();
+            if (test["errors"].size())
+            {
+                failures++;
+                for (auto const& error : test["errors"])
+                    std::cerr << name << " (" << shard << "): " << error.asString() << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Merged " << _files.size() << " shard results: " << tests.size()
+              << " tests, " << failures << " failures, total time " << totalTime << "s"
+              << std::endl;
+    if (!_output.empty())
+        dev::writeFile(_output, dev::asBytes(Json::StyledWriter().write(merged)));
+    return failures;
+}
+
+}  // namespace test
@@ -0,0 +1,73 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Split the test suite between several machines (--shard i/N)
+ */
+
+#pragma once
+#include <boost/filesystem/path.hpp>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace test
+{
+class TestSharding
+{
+public:
+    static TestSharding& get();
+
+    /// true if --shard i/N is set with N > 1
+    bool isEnabled() const;
+
+    /// Select the names that belong to the current shard
+    /// The split only depends on the names and the --shardtimes file, so every machine computes
+    /// the same partition. With timing history the names are packed into cost-balanced bins,
+    /// without it each name goes to the shard chosen by its hash.
+    std::set<std::string> selectShard(std::vector<std::string> const& _names) const;
+
+    /// Record the execution time and errors of a test for the --shardresult file
+    void registerResult(
+        std::string const& _name, double _time, std::vector<std::string> const& _errors);
+
+    /// Write registered results into --shardresult file if the option is set
+    void writeResults() const;
+
+    /// Combine per-shard result files into one report. Returns the number of failures: failed
+    /// tests, tests executed by more than one shard and shard files that could not be read
+    static size_t mergeResults(
+        std::vector<std::string> const& _files, boost::filesystem::path const& _output);
+
+private:
+    TestSharding();
+    TestSharding(TestSharding const&) = delete;
+    void loadTimingHistory(boost::filesystem::path const& _file);
+
+    struct TestResult
+    {
+        double time = 0;
+        std::vector<std::string> errors;
+    };
+
+    std::map<std::string, double> m_timingHistory;  ///< test name => seconds
+    std::map<std::string, TestResult> m_results;
+    std::mutex m_resultsMutex;
+};
+
+}  // namespace test
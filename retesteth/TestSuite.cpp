@@ -24,14 +24,23 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/Log.h>
 #include <libdevcore/SHA3.h>
+#include <retesteth/BinaryTestCache.h>
 #include <retesteth/DataObject.h>
+#include <retesteth/DistributedTests.h>
 #include <retesteth/EthChecks.h>
+#include <retesteth/LLLCompiler.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/FillerHashIndex.h>
 #include <retesteth/Options.h>
 #include <retesteth/RPCSession.h>
 #include <retesteth/TestHelper.h>
+#include <retesteth/TestFileCache.h>
+#include <retesteth/TestFileLoader.h>
 #include <retesteth/TestOutputHelper.h>
+#include <retesteth/TestSharding.h>
 #include <retesteth/TestSuite.h>
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <thread>
 
@@ -42,15 +51,13 @@ namespace fs = boost::filesystem;
 
 //Helper functions for test proccessing
 namespace {
-struct TestFileData
+test::TestFileData readTestFile(fs::path const& _testFileName)
 {
-    DataObject data;
-    h256 hash;
-};
+    test::TestFileData testData;
+    // The cache entry keeps the filler hash, so jsoncpp is not needed for unchanged fillers
+    if (test::BinaryTestCache::get().load(_testFileName, testData.data, testData.hash))
+        return testData;
 
-TestFileData readTestFile(fs::path const& _testFileName)
-{
-    TestFileData testData;
     Json::Value v = readJson(_testFileName);
     if (_testFileName.extension() == ".json")
         testData.data = test::convertJsonCPPtoData(v);
@@ -59,10 +66,9 @@ TestFileData readTestFile(fs::path const& _testFileName)
     else
         BOOST_ERROR("Unknow test format!" + test::TestOutputHelper::get().testFile().string());
 
-    Json::FastWriter fastWriter;
-    std::string output = fastWriter.write(v);
-    output = output.substr(0, output.size() - 1);
-    testData.hash = sha3(output);
+    testData.hash = test::fillerJsonHash(v);
+    if (testData.data.type() != test::DataType::Null)
+        test::BinaryTestCache::get().store(_testFileName, testData.data, testData.hash);
     return testData;
 }
 
@@ -117,25 +123,6 @@ void addClientInfo(test::DataObject& _v, fs::path const& _testSource, h256 const
     }
 }
 
-void checkFillerHash(fs::path const& _compiledTest, fs::path const& _sourceTest)
-{
-    test::DataObject v = test::convertJsonCPPtoData(test::readJson(_compiledTest));
-    TestFileData fillerData = readTestFile(_sourceTest);
-    for (auto const& i: v.getSubObjects())
-	{
-        // use eth object _info section class here !!!!!
-        ETH_REQUIRE_MESSAGE(i.type() == test::DataType::Object, i.getKey() + " should contain an object under a test name.");
-        ETH_REQUIRE_MESSAGE(i.count("_info") > 0, "_info section not set! " + _compiledTest.string());
-        test::DataObject const& info = i.at("_info");
-        ETH_REQUIRE_MESSAGE(info.count("sourceHash") > 0, "sourceHash not found in " + _compiledTest.string() + " in " + i.getKey());
-        h256 const sourceHash = h256(info.at("sourceHash").asString());
-        ETH_CHECK_MESSAGE(sourceHash == fillerData.hash,
-            "Test " + _compiledTest.string() + " in " + i.getKey() +
-                " is outdated. Filler hash is different! ( '" + sourceHash.hex().substr(0, 4) +
-                "' != '" + fillerData.hash.hex().substr(0, 4) + "') ");
-    }
-}
-
 void joinThreads(vector<thread>& _threadVector, bool _all)
 {
     if (_all)
@@ -177,6 +164,26 @@ namespace test
 string const c_fillerPostf = "Filler";
 string const c_copierPostf = "Copier";
 
+namespace
+{
+/// Name of the test generated from _fillerFile (stem without Filler/Copier postfix)
+string fillerTestName(fs::path const& _fillerFile)
+{
+    string testname = _fillerFile.stem().string();
+    if (testname.rfind(c_fillerPostf) != string::npos)
+        return testname.substr(0, testname.rfind(c_fillerPostf));
+    if (testname.rfind(c_copierPostf) != string::npos)
+        return testname.substr(0, testname.rfind(c_copierPostf));
+    return testname;
+}
+}
+
+bool TestSuite::shardByTestName() const
+{
+    // When filling, each shard must generate whole files
+    return hasManyTestsPerFile() && !Options::get().filltests;
+}
+
 void TestSuite::runTestWithoutFiller(boost::filesystem::path const& _file) const
 {
     // Allow to execute a custom test .json file on any test suite
@@ -194,8 +201,24 @@ string TestSuite::checkFillerExistance(string const& _testFolder) const
     std::cout << "Filter: " << filter << std::endl;
     vector<fs::path> const compiledFiles =
         test::getFiles(getFullPath(_testFolder), {".json", ".yml"}, filter);
+
+    // other shards check the rest of the files
+    bool const checkShardOnly = TestSharding::get().isEnabled() && !shardByTestName();
+    set<string> shard;
+    if (checkShardOnly)
+    {
+        vector<string> names;
+        for (auto const& file : compiledFiles)
+            names.push_back(file.stem().string());
+        shard = TestSharding::get().selectShard(names);
+    }
+
+    string result = "Error selecting filter!";
+    vector<pair<fs::path, fs::path>> hashChecks;  // compiled test => source
     for (auto const& file : compiledFiles)
     {
+        if (checkShardOnly && !shard.count(file.stem().string()))
+            continue;
         fs::path const expectedFillerName =
             getFullPathFiller(_testFolder) /
             fs::path(file.stem().string() + c_fillerPostf + ".json");
@@ -209,30 +232,43 @@ string TestSuite::checkFillerExistance(string const& _testFolder) const
         ETH_REQUIRE_MESSAGE(!(fs::exists(expectedFillerName) && fs::exists(expectedFillerName2) && fs::exists(expectedCopierName)), "Src test could either be Filler.json, Filler.yml or Copier.json: " + file.filename().string());
 
         // Check that filled tests created from actual fillers depenging on a test type
+        // If we are filling the test it is probably outdated/being updated. no need to check.
+        bool const checkHash = Options::get().filltests == false;
         if (fs::exists(expectedFillerName))
         {
-            if (Options::get().filltests == false)  // If we are filling the test it is probably
-                                                    // outdated/being updated. no need to check.
-                checkFillerHash(file, expectedFillerName);
+            if (checkHash)
+                hashChecks.push_back({file, expectedFillerName});
             if (!filter.empty())
-                return filter + c_fillerPostf;
+            {
+                result = filter + c_fillerPostf;
+                break;
+            }
         }
         if (fs::exists(expectedFillerName2))
         {
-            if (Options::get().filltests == false)
-                checkFillerHash(file, expectedFillerName2);
+            if (checkHash)
+                hashChecks.push_back({file, expectedFillerName2});
             if (!filter.empty())
-                return filter + c_fillerPostf;
+            {
+                result = filter + c_fillerPostf;
+                break;
+            }
         }
         if (fs::exists(expectedCopierName))
         {
-            if (Options::get().filltests == false)
-                checkFillerHash(file, expectedCopierName);
+            if (checkHash)
+                hashChecks.push_back({file, expectedCopierName});
             if (!filter.empty())
-                return filter + c_copierPostf;
+            {
+                result = filter + c_copierPostf;
+                break;
+            }
         }
     }
-    return string("Error selecting filter!");
+
+    // Unchanged files are checked by the hashes from the index without parsing
+    FillerHashIndex::get().checkFillerHashes(hashChecks);
+    return result;
 }
 
 void TestSuite::runAllTestsInFolder(string const& _testFolder) const
@@ -240,18 +276,51 @@ void TestSuite::runAllTestsInFolder(string const& _testFolder) const
     if (ExitHandler::shouldExit())
         return;
 
+    // the coordinator decides which files to run, it also checks the fillers
+    if (!Options::get().workerAddress.empty())
+    {
+        runFunctionForAllClients([this, &_testFolder]() { runDistributedTests(_testFolder); });
+        return;
+    }
+
     // check that destination folder test files has according Filler file in src folder
     string const filter = checkFillerExistance(_testFolder);
 
     // run all tests
-    vector<fs::path> const files =
+    vector<fs::path> files =
         test::getFiles(getFullPathFiller(_testFolder), {".json", ".yml"}, filter);
 
+    // leave only the files of this shard. tests inside the files are split by doTests otherwise
+    if (TestSharding::get().isEnabled() && !shardByTestName())
+    {
+        vector<string> names;
+        for (auto const& file : files)
+            names.push_back(fillerTestName(file));
+        set<string> const shard = TestSharding::get().selectShard(names);
+        files.erase(remove_if(files.begin(), files.end(),
+                        [&shard](fs::path const& _file) {
+                            return !shard.count(fillerTestName(_file));
+                        }),
+            files.end());
+    }
+
     // repeat this part for all connected clients
     auto thisPart = [this, &files, &_testFolder]() {
+        if (Options::get().coordinatorPort)
+        {
+            distributeTests(_testFolder, files);
+            return;
+        }
         auto& testOutput = test::TestOutputHelper::get();
         vector<thread> threadVector;
         testOutput.initTest(files.size());
+
+        // parse the next files while the clients are busy with the current ones
+        vector<TestFileLoader::LoadFunction> loaders;
+        for (auto const& file : files)
+            loaders.push_back(prefetchFunction(_testFolder, file));
+        TestFileLoader loader(loaders, Options::get().threadCount);
+
         for (auto const& file : files)
         {
             if (ExitHandler::shouldExit())
@@ -259,7 +328,9 @@ void TestSuite::runAllTestsInFolder(string const& _testFolder) const
             testOutput.showProgress();
             if (threadVector.size() == Options::get().threadCount)
                 joinThreads(threadVector, false);
-            thread testThread(&TestSuite::executeTest, this, _testFolder, file);
+            // the session is taken by the test thread only when its file is parsed
+            std::shared_ptr<TestFileData> testData = loader.next();
+            thread testThread(&TestSuite::executeTest, this, _testFolder, file, testData);
             threadVector.push_back(std::move(testThread));
         }
         joinThreads(threadVector, true);
@@ -268,6 +339,75 @@ void TestSuite::runAllTestsInFolder(string const& _testFolder) const
     runFunctionForAllClients(thisPart);
 }
 
+string TestSuite::distributedQueueName(string const& _testFolder) const
+{
+    // the coordinator and the workers must run the same client configs
+    return (suiteFillerFolder() / _testFolder).string() + ":" +
+           Options::getDynamicOptions().getCurrentConfig().getName();
+}
+
+void TestSuite::distributeTests(string const& _testFolder, vector<fs::path> const& _files) const
+{
+    auto& testOutput = test::TestOutputHelper::get();
+    testOutput.initTest(_files.size());
+
+    // workers could have the test repo at a different location
+    vector<fs::path> relativeFiles;
+    for (auto const& file : _files)
+        relativeFiles.push_back(fs::relative(file, getTestPath()));
+
+    TestCoordinator::get().runTasks(distributedQueueName(_testFolder), relativeFiles,
+        [&testOutput](TestCoordinator::TaskResult const& _result) {
+            testOutput.showProgress();
+            string const testname = fillerTestName(_result.file);
+            for (auto const& error : _result.errors)
+                ETH_ERROR(testname + ": " + error);
+            TestSharding::get().registerResult(testname, _result.time, _result.errors);
+        });
+    testOutput.finishTest();
+}
+
+void TestSuite::runDistributedTests(string const& _testFolder) const
+{
+    // the number of tests is not known in advance, so no progress here
+    auto& testOutput = test::TestOutputHelper::get();
+    testOutput.initTest(1);
+    string const queue = distributedQueueName(_testFolder);
+    vector<thread> threadVector;
+    while (!ExitHandler::shouldExit())
+    {
+        if (threadVector.size() == Options::get().threadCount)
+            joinThreads(threadVector, false);
+
+        size_t taskId;
+        fs::path file;
+        TestWorker::TaskStatus const status = TestWorker::get().requestTask(queue, taskId, file);
+        if (status == TestWorker::TaskStatus::Done)
+            break;
+        if (status == TestWorker::TaskStatus::Wait)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        thread testThread(&TestSuite::executeDistributedTask, this, _testFolder,
+            getTestPath() / file, taskId);
+        threadVector.push_back(std::move(testThread));
+    }
+    joinThreads(threadVector, true);
+    testOutput.finishTest();
+}
+
+void TestSuite::executeDistributedTask(
+    string const& _testFolder, fs::path const& _file, size_t _taskId) const
+{
+    dev::Timer executionTimer;
+    size_t const errorsBefore = TestOutputHelper::get().getErrors().size();
+    executeTest(_testFolder, _file);
+    vector<string> const& errors = TestOutputHelper::get().getErrors();
+    TestWorker::get().sendResult(_taskId, executionTimer.elapsed(),
+        vector<string>(errors.begin() + errorsBefore, errors.end()));
+}
+
 
 void TestSuite::runFunctionForAllClients(std::function<void()> _func)
 {
@@ -281,6 +421,38 @@ void TestSuite::runFunctionForAllClients(std::function<void()> _func)
     }
 }
 
+TestFileLoader::LoadFunction TestSuite::prefetchFunction(
+    string const& _testFolder, fs::path const& _fillerFile) const
+{
+    // Only json files are parsed in advance. Copier sources are not parsed when filling
+    string const stem = _fillerFile.stem().string();
+    bool const isFiller = stem.rfind(c_fillerPostf) != string::npos;
+    if (_fillerFile.extension() != ".json" || (!isFiller && stem.rfind(c_copierPostf) == string::npos))
+        return TestFileLoader::LoadFunction();
+
+    if (Options::get().filltests)
+    {
+        if (!isFiller)
+            return TestFileLoader::LoadFunction();
+        return [_fillerFile]() {
+            TestFileData testData = readTestFile(_fillerFile);
+            LLLCompiler::get().prefetchFiller(testData.data);
+            return testData;
+        };
+    }
+
+    // The filled test is executed. It is given to executeTest, the cache could have dropped it
+    // A single selected test is parsed alone by executeFile
+    if (!selectedTestName().empty())
+        return TestFileLoader::LoadFunction();
+    fs::path const testFile = getFullPath(_testFolder) / fs::path(fillerTestName(_fillerFile) + ".json");
+    return [testFile]() {
+        TestFileData testData;
+        testData.test = TestFileCache::get().load(testFile);
+        return testData;
+    };
+}
+
 fs::path TestSuite::getFullPathFiller(string const& _testFolder) const
 {
 	return test::getTestPath() / "src" / suiteFillerFolder() / _testFolder;
@@ -291,9 +463,12 @@ fs::path TestSuite::getFullPath(string const& _testFolder) const
 	return test::getTestPath() / suiteFolder() / _testFolder;
 }
 
-void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFileName) const
+void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFileName,
+    std::shared_ptr<TestFileData> _preloaded) const
 {
     RPCSession::sessionStart(TestOutputHelper::getThreadID());
+    dev::Timer executionTimer;
+    size_t const errorsBefore = TestOutputHelper::get().getErrors().size();
     fs::path const boostRelativeTestPath = fs::relative(_testFileName, getTestPath());
     string testname = _testFileName.stem().string();
     bool isCopySource = false;
@@ -331,7 +506,14 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
         }
         else
         {
-            TestFileData testData = readTestFile(_testFileName);
+            TestFileData testData;
+            if (_preloaded)
+                testData = std::move(*_preloaded);
+            else
+            {
+                testData = readTestFile(_testFileName);
+                LLLCompiler::get().prefetchFiller(testData.data);
+            }
             removeComments(testData.data);
             opt.doFilling = true;
 
@@ -342,7 +524,9 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
                 {
                     // Add client info for all of the tests in output
                     addClientInfo(output, boostRelativeTestPath, testData.hash);
-                    writeFile(boostTestPath, asBytes(output.asJson()));
+                    writeJsonFile(boostTestPath, output);
+                    // run the generated test without reading it back
+                    TestFileCache::get().store(boostTestPath, std::move(output));
                 }
             }
             catch (std::exception const& _ex)
@@ -361,7 +545,10 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
 
         try
         {
-            executeFile(boostTestPath);
+            if (_preloaded && _preloaded->test)
+                executeData(*_preloaded->test);
+            else
+                executeFile(boostTestPath);
         }
         catch (std::exception const& _ex)
         {
@@ -369,13 +556,29 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
             RPCSession::sessionEnd(TestOutputHelper::getThreadID(), RPCSession::SessionStatus::HasFinished);
         }
     }
+
+    // Tests split by name are registered one by one in doTests
+    if (!shardByTestName())
+    {
+        vector<string> const& errors = TestOutputHelper::get().getErrors();
+        TestSharding::get().registerResult(testname, executionTimer.elapsed(),
+            vector<string>(errors.begin() + errorsBefore, errors.end()));
+    }
     RPCSession::sessionEnd(TestOutputHelper::getThreadID(), RPCSession::SessionStatus::HasFinished);
 }
 
 void TestSuite::executeFile(boost::filesystem::path const& _file) const
+{
+    // Sharding by name has to see every test name of the file
+    string const testName = TestSharding::get().isEnabled() ? string() : selectedTestName();
+    executeData(*TestFileCache::get().load(_file, testName));
+}
+
+void TestSuite::executeData(DataObject const& _test) const
 {
     TestSuiteOptions opt;
-    doTests(test::convertJsonCPPtoData(readJson(_file)), opt);
+    opt.shardByTestName = shardByTestName();
+    doTests(_test, opt);
 }
 
 }
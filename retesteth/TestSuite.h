@@ -20,8 +20,10 @@
 
 #pragma once
 #include <retesteth/DataObject.h>
+#include <retesteth/TestFileLoader.h>
 #include <boost/filesystem/path.hpp>
 #include <functional>
+#include <memory>
 
 namespace test
 {
@@ -31,7 +33,20 @@ class TestSuite
 private:
 	// Execute Test.json file
 	void executeFile(boost::filesystem::path const& _file) const;
+	// Execute parsed Test.json file
+	void executeData(DataObject const& _test) const;
+	// Parse the file that executeTest reads first for _fillerFile. Empty if nothing to parse
+	TestFileLoader::LoadFunction prefetchFunction(std::string const& _testFolder, boost::filesystem::path const& _fillerFile) const;
     std::string checkFillerExistance(std::string const& _testFolder) const;
+    // Split single tests between the shards instead of whole files
+    bool shardByTestName() const;
+    // Name of the coordinator queue for _testFolder of the current client config
+    std::string distributedQueueName(std::string const& _testFolder) const;
+    // Serve the files of _testFolder to the workers (--coordinator)
+    void distributeTests(std::string const& _testFolder, std::vector<boost::filesystem::path> const& _files) const;
+    // Execute files of _testFolder given by the coordinator (--worker)
+    void runDistributedTests(std::string const& _testFolder) const;
+    void executeDistributedTask(std::string const& _testFolder, boost::filesystem::path const& _file, size_t _taskId) const;
 
 protected:
 	// A folder of the test suite. like "VMTests". should be implemented for each test suite.
@@ -40,15 +55,23 @@ protected:
 	// A folder of the test suite in src folder. like "VMTestsFiller". should be implemented for each test suite.
 	virtual boost::filesystem::path suiteFillerFolder() const = 0;
 
+	// A test file of the suite contains many tests. Such tests are split between shards by name.
+	virtual bool hasManyTestsPerFile() const { return false; }
+
+	// The only test to run from a file with many tests, empty if all of them run.
+	// The other tests of the file are skipped by the parser without being built.
+	virtual std::string selectedTestName() const { return std::string(); }
+
 public:
 
 	virtual ~TestSuite() {}
 
     struct TestSuiteOptions
     {
-        TestSuiteOptions(): doFilling(false), wasErrors(false) {}
+        TestSuiteOptions(): doFilling(false), wasErrors(false), shardByTestName(false) {}
         bool doFilling;
         bool wasErrors;
+        bool shardByTestName;  // doTests should run only the tests of the current shard
     };
 
 	// Main test executive function. should be declared for each test suite. it fills and runs the test .json file
@@ -63,7 +86,9 @@ public:
 	void runAllTestsInFolder(std::string const& _testFolder) const;
 
 	// Execute Filler.json or Copier.json test file in a given folder
-	void executeTest(std::string const& _testFolder, boost::filesystem::path const& _jsonFileName) const;
+	// _preloaded is the parsed filler when filling, the filled test otherwise (see prefetchFunction)
+	void executeTest(std::string const& _testFolder, boost::filesystem::path const& _jsonFileName,
+		std::shared_ptr<TestFileData> _preloaded = std::shared_ptr<TestFileData>()) const;
 
 	// Execute Test.json file
 	void runTestWithoutFiller(boost::filesystem::path const& _file) const;
@@ -0,0 +1,170 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Sign test transactions ahead of the execution
+ */
+
+#include <libdevcore/RLPWriter.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/TransactionSigner.h>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+/// Signed transactions that are kept. Over the limit the signed ones are dropped
+size_t const c_maxSignedTransactions = 65536;
+
+void appendFields(RLPWriter& _s, test::TransactionFields const& _tr)
+{
+    _s << _tr.nonce;
+    _s << _tr.gasPrice;
+    _s << _tr.gasLimit;
+    if (_tr.creation)
+        _s << "";
+    else
+        _s << _tr.to;
+    _s << _tr.value;
+    _s << _tr.data;
+}
+}  // namespace
+
+namespace test
+{
+TransactionSigner& TransactionSigner::get()
+{
+    static TransactionSigner instance;
+    return instance;
+}
+
+TransactionSigner::~TransactionSigner()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_queueUpdate.notify_all();
+    for (auto& th : m_threads)
+        th.join();
+}
+
+h256 TransactionSigner::unsignedHash(TransactionFields const& _tr)
+{
+    return sha3(rlpEncode([&_tr](RLPWriter& _s) {
+        _s.appendList();
+        appendFields(_s, _tr);
+        _s.endList();
+    }));
+}
+
+string TransactionSigner::signTransaction(TransactionFields const& _tr, h256 const& _hash)
+{
+    SignatureStruct const sig(dev::sign(_tr.secretKey, _hash));
+    if (!sig.isValid())
+        return string();
+
+    byte const v = 27 + sig.v;
+    u256 const r = (u256)sig.r;
+    u256 const s = (u256)sig.s;
+    return rlpEncodeHexPrefixed([&](RLPWriter& _s) {
+        _s.appendList();
+        appendFields(_s, _tr);
+        _s << v;
+        _s << r;
+        _s << s;
+        _s.endList();
+    });
+}
+
+void TransactionSigner::prefetch(TransactionFields const& _tr)
+{
+    h256 const hash = unsignedHash(_tr);
+    Key const key(_tr.secretKey.makeInsecure(), hash);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_signed.count(key))
+        return;
+
+    if (m_signed.size() >= c_maxSignedTransactions)
+    {
+        for (auto it = m_signed.begin(); it != m_signed.end();)
+        {
+            if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                it = m_signed.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::packaged_task<string()> task([_tr, hash]() { return signTransaction(_tr, hash); });
+    m_signed[key] = task.get_future().share();
+    m_queue.push_back(std::move(task));
+    if (m_threads.empty())
+    {
+        size_t const threadCount = max(std::thread::hardware_concurrency(), 1u);
+        for (size_t i = 0; i < threadCount; i++)
+            m_threads.push_back(thread(&TransactionSigner::signTransactions, this));
+    }
+    m_queueUpdate.notify_one();
+}
+
+string TransactionSigner::sign(TransactionFields const& _tr)
+{
+    h256 const hash = unsignedHash(_tr);
+    Key const key(_tr.secretKey.makeInsecure(), hash);
+    std::shared_future<string> signedRLP;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto const it = m_signed.find(key);
+        if (it != m_signed.end())
+            signedRLP = it->second;
+    }
+    // rethrows the error of the signer thread
+    if (signedRLP.valid())
+        return signedRLP.get();
+
+    string const result = signTransaction(_tr, hash);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_signed.size() < c_maxSignedTransactions)
+    {
+        std::promise<string> ready;
+        ready.set_value(result);
+        m_signed[key] = ready.get_future().share();
+    }
+    return result;
+}
+
+void TransactionSigner::signTransactions()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_queueUpdate.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+        if (m_stop)
+            return;
+        std::packaged_task<string()> task = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+}  // namespace test
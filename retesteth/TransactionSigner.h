@@ -0,0 +1,85 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file
+ * Sign test transactions ahead of the execution
+ */
+
+#pragma once
+#include <libdevcore/Address.h>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcrypto/Common.h>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace test
+{
+/// Fields of a transaction to be signed
+struct TransactionFields
+{
+    dev::u256 nonce;
+    dev::u256 gasPrice;
+    dev::u256 gasLimit;
+    bool creation;  ///< the transaction has no "to" address
+    dev::Address to;
+    dev::u256 value;
+    dev::bytes data;
+    dev::Secret secretKey;
+};
+
+/// Signs transactions on background threads. A transaction is signed once per process
+/// for each secret key, then the signed RLP is taken from the cache.
+class TransactionSigner
+{
+public:
+    static TransactionSigner& get();
+    ~TransactionSigner();
+
+    /// Start signing _tr on a signer thread unless it is signed already
+    void prefetch(TransactionFields const& _tr);
+
+    /// Signed RLP of _tr as a 0x prefixed hex string. Empty if the signature is invalid.
+    /// Waits for the signer thread if _tr is being signed, signs it on this thread if it
+    /// was not prefetched.
+    std::string sign(TransactionFields const& _tr);
+
+    /// Hash of the transaction without the signature
+    static dev::h256 unsignedHash(TransactionFields const& _tr);
+
+private:
+    TransactionSigner() {}
+    TransactionSigner(TransactionSigner const&) = delete;
+    typedef std::pair<dev::h256, dev::h256> Key;  ///< secret key, unsigned hash
+    static std::string signTransaction(TransactionFields const& _tr, dev::h256 const& _hash);
+    void signTransactions();
+
+    std::mutex m_mutex;
+    std::map<Key, std::shared_future<std::string>> m_signed;
+    std::deque<std::packaged_task<std::string()>> m_queue;
+    std::condition_variable m_queueUpdate;
+    std::vector<std::thread> m_threads;  ///< started on the first prefetch
+    bool m_stop = false;
+};
+
+}  // namespace test
@@ -0,0 +1,103 @@
+#include "blockRLP.h"
+#include <libdevcore/CommonIO.h>
+#include <cassert>
+using namespace std;
+using namespace dev;
+using namespace test;
+
+namespace
+{
+size_t const c_anySize = 0;
+size_t const c_intSize = 1;  ///< an integer of up to 32 bytes
+
+/// parentHash, uncleHash, coinbase, stateRoot, transactionsTrie, receiptTrie, bloom, difficulty,
+/// number, gasLimit, gasUsed, timestamp, extraData, mixHash, nonce
+size_t const c_headerFieldSizes[] = {32, 32, 20, 32, 32, 32, 256, c_intSize, c_intSize, c_intSize,
+    c_intSize, c_intSize, c_anySize, 32, 8};
+size_t const c_headerFields = sizeof(c_headerFieldSizes) / sizeof(c_headerFieldSizes[0]);
+size_t const c_transactionFields = 9;
+size_t const c_maxDepth = 8;
+
+string checkHeader(RLP const& _header)
+{
+    if (!_header.isList() || _header.itemCount() != c_headerFields)
+        return "header is expected to be a list of " + toString(c_headerFields) + " fields";
+    for (size_t i = 0; i < c_headerFields; i++)
+    {
+        RLP const field = _header[i];
+        size_t const size = field.isData() ? field.toBytesConstRef().size() : 0;
+        if (!field.isData() || (c_headerFieldSizes[i] == c_intSize && size > 32) ||
+            (c_headerFieldSizes[i] > c_intSize && size != c_headerFieldSizes[i]))
+            return "header field " + toString(i) + " has a wrong type or size";
+    }
+    return string();
+}
+}  // namespace
+
+blockRLP::blockRLP(bytesConstRef _rlp)
+{
+    try
+    {
+        RLP const block(_rlp, RLP::VeryStrict);
+        if (!block.isList())
+            m_error = "block is not a list";
+        else
+        {
+            checkItems(block, 0);
+            if (block.itemCount() != 3)
+                m_error = "block is expected to have a header, transactions and uncles";
+            else if (!block[1].isList() || !block[2].isList())
+                m_error = "transactions and uncles are expected to be lists";
+            else
+                m_error = checkHeader(block[0]);
+
+            for (size_t i = 0; m_error.empty() && i < block[1].itemCount(); i++)
+            {
+                RLP const tr = block[1][i];
+                if (!tr.isList() || tr.itemCount() != c_transactionFields)
+                    m_error = "transaction " + toString(i) + " is expected to be a list of " +
+                              toString(c_transactionFields) + " fields";
+            }
+            for (size_t i = 0; m_error.empty() && i < block[2].itemCount(); i++)
+            {
+                string const error = checkHeader(block[2][i]);
+                if (!error.empty())
+                    m_error = "uncle " + toString(i) + ": " + error;
+            }
+
+            if (m_error.empty())
+            {
+                m_header = block[0];
+                m_transactions = block[1];
+                m_uncles = block[2];
+            }
+        }
+    }
+    catch (std::exception const& _ex)
+    {
+        m_error = string("rlp is malformed: ") + _ex.what();
+    }
+}
+
+void blockRLP::checkItems(RLP const& _list, size_t _depth)
+{
+    // The items have to fill the payload of the list exactly
+    bytesConstRef payload = _list.payload();
+    while (!payload.empty())
+    {
+        RLP const item(payload, RLP::ThrowOnFail | RLP::FailIfTooSmall);
+        if (item.isList())
+        {
+            if (_depth >= c_maxDepth)
+                BOOST_THROW_EXCEPTION(BadRLP());
+            checkItems(item, _depth + 1);
+        }
+        payload = payload.cropped(item.actualSize());
+    }
+}
+
+RLP blockRLP::headerField(size_t _index) const
+{
+    assert(isValid());
+    return m_header[_index];
+}
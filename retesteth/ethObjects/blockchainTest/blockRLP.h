@@ -0,0 +1,39 @@
+#pragma once
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/RLP.h>
+#include <string>
+
+namespace test
+{
+/// A block of a blockchain test read from its RLP. The header, the transactions and the uncles
+/// are views into the given bytes, nothing is copied. The bytes have to outlive the object.
+class blockRLP
+{
+public:
+    blockRLP(dev::bytesConstRef _rlp);
+
+    /// Whether the RLP has the structure of a block. If not, error() tells what is wrong
+    bool isValid() const { return m_error.empty(); }
+    std::string const& error() const { return m_error; }
+
+    dev::RLP const& header() const { return m_header; }
+    dev::h256 parentHash() const { return headerField(0).toHash<dev::h256>(); }
+    dev::u256 number() const { return headerField(8).toInt<dev::u256>(); }
+    dev::u256 gasLimit() const { return headerField(9).toInt<dev::u256>(); }
+    dev::u256 gasUsed() const { return headerField(10).toInt<dev::u256>(); }
+    dev::u256 timestamp() const { return headerField(11).toInt<dev::u256>(); }
+
+    dev::RLP const& transactions() const { return m_transactions; }
+    size_t transactionCount() const { return m_transactions.itemCount(); }
+    size_t uncleCount() const { return m_uncles.itemCount(); }
+
+private:
+    dev::RLP headerField(size_t _index) const;
+    static void checkItems(dev::RLP const& _list, size_t _depth);
+
+    dev::RLP m_header;
+    dev::RLP m_transactions;
+    dev::RLP m_uncles;
+    std::string m_error;
+};
+}
@@ -1,36 +1,95 @@
 #include "object.h"
 #include <retesteth/TestHelper.h>
-#include <mutex>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-namespace test {
+namespace
+{
+uint8_t const c_hexDigit = 1;
+uint8_t const c_decimalDigit = 2;
 
-std::mutex g_strFindMutex;
-object::DigitsType object::stringIntegerType(std::string const& _string)
+struct DigitTable
 {
-    if (_string[0] == '0' && _string[1] == 'x')
+    DigitTable()
     {
-        DigitsType substringType = stringIntegerType(_string.substr(2));
-        if (substringType == DigitsType::Hex || substringType == DigitsType::Decimal)
-            return DigitsType::HexPrefixed;
+        memset(classes, 0, sizeof(classes));
+        for (char c = '0'; c <= '9'; c++)
+            classes[uint8_t(c)] = c_hexDigit | c_decimalDigit;
+        for (char c = 'a'; c <= 'f'; c++)
+        {
+            classes[uint8_t(c)] = c_hexDigit;
+            classes[uint8_t(c - 'a' + 'A')] = c_hexDigit;
+        }
     }
+    uint8_t classes[256];
+};
 
-    bool isDecimalOnly = true;
-    std::lock_guard<std::mutex> lock(
-        g_strFindMutex); // string.find is not thread safe + static
-    static std::string hexAlphabet = "0123456789abcdefABCDEF";
-    static std::string decimalAlphabet = "0123456789";
-    for (size_t i = 0; i < _string.length(); i++)
+/// Digit classes that all characters of [_pos, _end) have in common
+uint8_t commonDigitClasses(char const* _pos, char const* _end)
+{
+    uint8_t result = c_hexDigit | c_decimalDigit;
+#if defined(__SSE2__)
+    // Code and data fields are long, they are checked 16 characters at a time
+    __m128i const zero = _mm_set1_epi8('0');
+    __m128i const nine = _mm_set1_epi8('9');
+    __m128i const a = _mm_set1_epi8('a');
+    __m128i const f = _mm_set1_epi8('f');
+    __m128i const lowerCase = _mm_set1_epi8(0x20);
+    for (; _end - _pos >= 16; _pos += 16)
     {
-        if (hexAlphabet.find(_string[i]) == std::string::npos)
-           return DigitsType::String;
-
-        if (decimalAlphabet.find(_string[i]) == std::string::npos)
-            isDecimalOnly = false;
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_pos));
+        // _min <= c <= _max is max(min(c, _max), _min) == c for unsigned bytes
+        __m128i const decimal =
+            _mm_cmpeq_epi8(_mm_max_epu8(_mm_min_epu8(chunk, nine), zero), chunk);
+        __m128i const lower = _mm_or_si128(chunk, lowerCase);
+        __m128i const letter = _mm_cmpeq_epi8(_mm_max_epu8(_mm_min_epu8(lower, f), a), lower);
+        if (_mm_movemask_epi8(_mm_or_si128(decimal, letter)) != 0xFFFF)
+            return 0;
+        if (_mm_movemask_epi8(decimal) != 0xFFFF)
+            result = c_hexDigit;
     }
+#endif
+    static DigitTable const table;
+    for (; _pos < _end && result; _pos++)
+        result &= table.classes[uint8_t(*_pos)];
+    return result;
+}
 
-    if (isDecimalOnly)
-        return DigitsType::Decimal;
+/// toCompactHexPrefixed(u256("0x" + _hex), _minBytes) without the conversion to a number
+std::string compactHexPrefixed(std::string const& _hex, size_t _minBytes)
+{
+    size_t const start = std::min(_hex.find_first_not_of('0'), _hex.size());
+    size_t const digits = _hex.size() - start;
+    std::string result;
+    result.reserve(std::max(digits + 1, _minBytes * 2) + 2);
+    result += "0x";
+    if (digits == 0)
+        result.append(_minBytes * 2, '0');
+    else if (digits % 2)
+        result += '0';
+    for (size_t i = start; i < _hex.size(); i++)
+        result += char(_hex[i] | 0x20);  // lower case, digits do not change
+    return result;
+}
+}  // namespace
+
+namespace test {
 
+object::DigitsType object::stringIntegerType(std::string const& _string)
+{
+    // Only one 0x prefix is allowed, the rest of the string must be digits
+    bool const prefixed = _string.size() >= 2 && _string[0] == '0' && _string[1] == 'x';
+    char const* const begin = _string.data() + (prefixed ? 2 : 0);
+    uint8_t const classes = commonDigitClasses(begin, _string.data() + _string.size());
+    if (!classes)
+        return DigitsType::String;
+    if (prefixed)
+        return DigitsType::HexPrefixed;
+    if (classes & c_decimalDigit)
+        return DigitsType::Decimal;
     return DigitsType::Hex;
 }
 
@@ -67,10 +126,13 @@ void object::makeKeyHex(DataObject& _key)
         return;
     // make empty data and code fields as "0x", others as "0x00" if 0
     static std::set<std::string> empty0xFields = {"data", "code"};
-    if(stringIntegerType(_key.asString()) == DigitsType::Decimal)
-        _key = dev::toCompactHexPrefixed(dev::u256(_key.asString()),
+    DigitsType const type = stringIntegerType(_key.asString());
+    if (type == DigitsType::Decimal)
+        _key = dev::toCompactHexPrefixed(_key.asU256(),
                                         empty0xFields.count(_key.getKey()) ? 0 : 1);
-    else if(stringIntegerType(_key.asString()) == DigitsType::Hex)
+    else if (type == DigitsType::Hex && _key.asString().size() <= 64)
+        _key = compactHexPrefixed(_key.asString(), empty0xFields.count(_key.getKey()) ? 0 : 1);
+    else if (type == DigitsType::Hex)
         _key = dev::toCompactHexPrefixed(dev::u256("0x" + _key.asString()),
                                         empty0xFields.count(_key.getKey()) ? 0 : 1);
 }
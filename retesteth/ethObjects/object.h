@@ -8,6 +8,7 @@ namespace test {
 	{
         public:
             object(DataObject const& _json) : m_data(_json) {}
+            object(DataObject&& _json) : m_data(std::move(_json)) {}
             DataObject const& getData() const { return m_data; }
 
             enum DigitsType
@@ -2,6 +2,7 @@
 #include "../object.h"
 #include <libdevcore/Address.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/RLPWriter.h>
 using namespace dev;
 
 namespace test {
@@ -57,54 +58,56 @@ namespace test {
         {
             // RLP of a block
             // rlpHead .. blockinfo transactions uncles
-            RLPStream stream(3);
-            RLPStream header;
-            header.appendList(15);
-            header << h256(m_data.at("parentHash").asString());
-            header << h256(m_data.at("sha3Uncles").asString());
-            header << dev::Address(m_data.at("author").asString());
-            header << h256(m_data.at("stateRoot").asString());
-            header << h256(m_data.at("transactionsRoot").asString());
-            header << h256(m_data.at("receiptsRoot").asString());
-            header << h2048(m_data.at("logsBloom").asString());
-            header << u256(m_data.at("totalDifficulty").asString());
-            header << u256(m_data.at("number").asString());
-            header << u256(m_data.at("gasLimit").asString());
-            header << u256(m_data.at("gasUsed").asString());
-            header << u256(m_data.at("timestamp").asString());
-            header << dev::fromHex(m_data.at("extraData").asString());
-            header << h256(m_data.at("mixHash").asString());
-            header << u256(m_data.at("nonce").asString());
-            stream.appendRaw(header.out());
+            h2048 const logsBloom(m_data.at("logsBloom").asString());
+            return rlpEncodeHexPrefixed([&](RLPWriter& _rlp) {
+                _rlp.appendList();
+                _rlp.appendList();
+                _rlp << m_data.at("parentHash").asHash();
+                _rlp << m_data.at("sha3Uncles").asHash();
+                _rlp << m_data.at("author").asAddress();
+                _rlp << m_data.at("stateRoot").asHash();
+                _rlp << m_data.at("transactionsRoot").asHash();
+                _rlp << m_data.at("receiptsRoot").asHash();
+                _rlp << logsBloom;
+                _rlp << m_data.at("totalDifficulty").asU256();
+                _rlp << m_data.at("number").asU256();
+                _rlp << m_data.at("gasLimit").asU256();
+                _rlp << m_data.at("gasUsed").asU256();
+                _rlp << m_data.at("timestamp").asU256();
+                _rlp << m_data.at("extraData").asBytes();
+                _rlp << m_data.at("mixHash").asHash();
+                _rlp << m_data.at("nonce").asU256();
+                _rlp.endList();
 
-            if (m_data.at("transactions").getSubObjects().size())
-            {
-                RLPStream transactionList(1);
-                RLPStream transactionRLP(9);
-                DataObject transaction = m_data.at("transactions").getSubObjects().at(0);
-                transactionRLP << u256(transaction.at("nonce").asString());
-                transactionRLP << u256(transaction.at("gasPrice").asString());
-                transactionRLP << u256(transaction.at("gas").asString());
-                if (transaction.at("to").type() == DataType::Null ||
-                    transaction.at("to").asString().empty())
-                    transactionRLP << "";
-                else
-                    transactionRLP << Address(transaction.at("to").asString());
-                transactionRLP << u256(transaction.at("value").asString());
-                transactionRLP << fromHex(transaction.at("input").asString());
+                // the first transaction only, or an empty transaction list
+                _rlp.appendList();
+                if (m_data.at("transactions").getSubObjects().size())
+                {
+                    DataObject const& transaction = m_data.at("transactions").getSubObjects().at(0);
+                    _rlp.appendList();
+                    _rlp << transaction.at("nonce").asU256();
+                    _rlp << transaction.at("gasPrice").asU256();
+                    _rlp << transaction.at("gas").asU256();
+                    if (transaction.at("to").type() == DataType::Null ||
+                        transaction.at("to").asString().empty())
+                        _rlp << "";
+                    else
+                        _rlp << transaction.at("to").asAddress();
+                    _rlp << transaction.at("value").asU256();
+                    _rlp << transaction.at("input").asBytes();
 
-                byte v = 27 + (int)u256(transaction.at("v").asString().c_str());
-                transactionRLP << v;
-                transactionRLP << u256(transaction.at("r").asString());
-                transactionRLP << u256(transaction.at("s").asString());
-                transactionList.appendRaw(transactionRLP.out());
-                stream.appendRaw(transactionList.out());
-            }
-            else
-                stream.appendRaw(RLPStream(0).out());  // empty transaction list
-            stream.appendRaw(RLPStream(0).out());  // empty uncle list
+                    byte v = 27 + (int)transaction.at("v").asU256();
+                    _rlp << v;
+                    _rlp << transaction.at("r").asU256();
+                    _rlp << transaction.at("s").asU256();
+                    _rlp.endList();
+                }
+                _rlp.endList();
 
-            return dev::toHexPrefixed(stream.out());
+                _rlp.appendList();  // empty uncle list
+                _rlp.endList();
+                _rlp.endList();
+            });
         }
     };
 }
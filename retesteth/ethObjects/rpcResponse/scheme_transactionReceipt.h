@@ -69,10 +69,10 @@ namespace test {
 			{
 				std::vector<dev::h256> topics;
 				for (auto const& topic: m_data.at("topics").getSubObjects())
-					topics.push_back(dev::h256(topic.asString()));
+					topics.push_back(topic.asHash());
 
-				_rlp.appendList(3) << dev::Address(m_data.at("address").asString())
-								<< topics << dev::fromHex(m_data.at("data").asString());
+				_rlp.appendList(3) << m_data.at("address").asAddress()
+								<< topics << m_data.at("data").asBytes();
 			}
 		};
 
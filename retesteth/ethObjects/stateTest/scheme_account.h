@@ -32,7 +32,7 @@ namespace  test {
 			// Compile the code
 			m_data["code"] = test::replaceCode(m_data.at("code").asString());
             m_data["balance"] = dev::toCompactHexPrefixed(
-                u256(m_data.at("balance").asString()), 1);  // fix odd strings
+                m_data.at("balance").asU256(), 1);  // fix odd strings
 
             // Make all fields hex
             m_data.setKey(makeHexAddress(m_data.getKey()));
@@ -1,6 +1,7 @@
 #pragma once
 #include "../object.h"
 #include "scheme_account.h"
+#include <unordered_map>
 
 namespace  test {
 
@@ -51,10 +52,17 @@ namespace  test {
             ETH_REQUIRE(_storage.type() == DataType::Object);
             ETH_REQUIRE(hasStorage());
 
+            // One pass over each storage, the slots of _storage are found by key value
+            std::unordered_map<dev::h256, DataObject const*> storageIndex;
+            storageIndex.reserve(_storage.getSubObjects().size());
+            for (auto const& element: _storage.getSubObjects())
+                storageIndex[storageKey(element.getKey())] = &element;
+
             DataObject const& expectStorage = m_data.at("storage");
             for (auto const& element: expectStorage.getSubObjects())
             {
-                checkMessage(_storage.count(element.getKey()),
+                auto const slot = storageIndex.find(storageKey(element.getKey()));
+                checkMessage(slot != storageIndex.end(),
                    CompareResult::IncorrectStorage,
                    TestOutputHelper::get().testName() + " '" + address() + "' expected storage key: '"
                     + element.getKey() + "' to be set!");
@@ -62,11 +70,11 @@ namespace  test {
                 if (result != CompareResult::Success)
                     return result;
 
-                std::string valueInStorage = _storage.at(element.getKey()).asString();
-                checkMessage(valueInStorage == element.asString(),
+                DataObject const& valueInStorage = *slot->second;
+                checkMessage(valueInStorage.asU256() == element.asU256(),
                    CompareResult::IncorrectStorage,
                    TestOutputHelper::get().testName() + " Check State: " + address()
-                   + ": incorrect storage [" + element.getKey() + "] = " + valueInStorage
+                   + ": incorrect storage [" + element.getKey() + "] = " + valueInStorage.asString()
                    + ", expected [" + element.getKey() + "] = " + element.asString());
             }
             checkMessage(expectStorage.getSubObjects().size() == _storage.getSubObjects().size(),
@@ -75,6 +83,9 @@ namespace  test {
             return result;
         }
 
+        /// Storage keys are compared as numbers, "0x01" and "0x0001" are the same slot
+        static dev::h256 storageKey(std::string const& _key) { return dev::h256(dev::toU256(_key)); }
+
         private:
         bool m_shouldNotExist;
         bool m_hasBalance;
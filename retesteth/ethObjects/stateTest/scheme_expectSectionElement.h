@@ -34,6 +34,10 @@ namespace  test {
                 getExpectStateUnsafe().setBalance(_coinbaseAddress, origBalance + balance);
             }
         }
+        std::set<int> const& getDataIndexes() const { return m_dataIndexes; }
+        std::set<int> const& getGasIndexes() const { return m_gasIndexes; }
+        std::set<int> const& getValueIndexes() const { return m_valueIndexes; }
+
         bool checkIndexes(int _d, int _g, int _v) const
         {
             if ((m_dataIndexes.count(_d) || m_dataIndexes.count(-1)) &&
@@ -46,19 +46,19 @@ CompareResult compareStates(scheme_expectState const& _stateExpect, scheme_state
 
         if (a.hasBalance())
 		{
-          u256 inStateB = u256(inState.getData().at("balance").asString());
-          checkMessage(
-              a.getData().at("balance").asString() == inState.getData().at("balance").asString(),
+          u256 const& inStateB = inState.getData().at("balance").asU256();
+          u256 const& expectB = a.getData().at("balance").asU256();
+          checkMessage(expectB == inStateB,
               CompareResult::IncorrectBalance,
               TestOutputHelper::get().testName() + " Check State: '" + a.address() +
                   "': incorrect balance " + toString(inStateB) + ", expected " +
-                  toString(u256(a.getData().at("balance").asString())) + " (" +
+                  toString(expectB) + " (" +
                   a.getData().at("balance").asString() +
                   " != " + inState.getData().at("balance").asString() + ")");
         }
 
         if (a.hasNonce())
-            checkMessage(a.getData().at("nonce").asString() == inState.getData().at("nonce").asString(),
+            checkMessage(a.getData().at("nonce").asU256() == inState.getData().at("nonce").asU256(),
                 CompareResult::IncorrectNonce,
                 TestOutputHelper::get().testName() + " Check State: '" + a.address()
                 + "': incorrect nonce " + inState.getData().at("nonce").asString() + ", expected "
@@ -72,7 +72,7 @@ CompareResult compareStates(scheme_expectState const& _stateExpect, scheme_state
         }
 
         if (a.hasCode())
-            checkMessage(a.getData().at("code").asString() == inState.getData().at("code").asString(),
+            checkMessage(a.getData().at("code").asBytes() == inState.getData().at("code").asBytes(),
                 CompareResult::IncorrectCode,
                 TestOutputHelper::get().testName() + " Check State: '" + a.address()
                 + "': incorrect code '" + inState.getData().at("code").asString() + "', expected '"
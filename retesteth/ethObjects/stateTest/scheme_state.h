@@ -1,6 +1,8 @@
 #pragma once
 #include "scheme_account.h"
+#include <libdevcore/Address.h>
 #include <retesteth/DataObject.h>
+#include <unordered_map>
 
 namespace test {
 
@@ -10,31 +12,34 @@ namespace test {
 		scheme_state(DataObject const& _state):
 			object(_state)
 		{
-            for (auto const& accountObj : _state.getSubObjects())
-                m_accounts.push_back(scheme_account(accountObj));
-            refreshData();
+            parseAccounts();
+		}
+
+		scheme_state(DataObject&& _state):
+			object(std::move(_state))
+		{
+            parseAccounts();
 		}
 
         std::vector<scheme_account> const& getAccounts() {return m_accounts; }
         bool hasAccount(std::string const& _address) const
         {
-            for (auto const& a: m_accounts)
-            {
-                if (a.getData().getKey() == _address)
-                    return true;
-            }
-            return false;
+            return m_accountIndex.count(accountKey(_address));
         }
 
         scheme_account const& getAccount(std::string const& _account) const
         {
             assert(hasAccount(_account));
-            for (auto const& a: m_accounts)
-            {
-                if (a.getData().getKey() == _account)
-                    return a;
-            }
-            return m_accounts[0]; // should never reach this line
+            return m_accounts.at(m_accountIndex.at(accountKey(_account)));
+        }
+
+        /// Accounts are found by address value, so the case of hex letters does not matter.
+        /// A key that is not 20 bytes of hex only matches the same string.
+        static std::string accountKey(std::string const& _address)
+        {
+            if (!dev::isHash<dev::Address>(_address))
+                return _address;
+            return dev::toHexPrefixed(dev::fromHex(_address));
         }
 
         // Insert precompiled account info into genesis
@@ -42,6 +47,19 @@ namespace test {
 
       private:
         std::vector<scheme_account> m_accounts;
+        std::unordered_map<std::string, size_t> m_accountIndex;  ///< position in m_accounts
+        void parseAccounts()
+        {
+            m_accounts.reserve(m_data.getSubObjects().size());
+            m_accountIndex.reserve(m_data.getSubObjects().size());
+            for (auto const& accountObj : m_data.getSubObjects())
+            {
+                m_accounts.push_back(scheme_account(accountObj));
+                m_accountIndex[accountKey(m_accounts.back().getData().getKey())] =
+                    m_accounts.size() - 1;
+            }
+            refreshData();
+        }
         void refreshData()
         {
             //update data from account list
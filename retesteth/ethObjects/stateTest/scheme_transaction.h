@@ -3,6 +3,7 @@
 #include "scheme_account.h"
 
 #include <retesteth/TestHelper.h>
+#include <retesteth/TransactionSigner.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/SHA3.h>
 #include <libdevcrypto/Common.h>
@@ -32,64 +33,55 @@ namespace test {
             makeAllFieldsHex(m_data);
 		}
 
-        std::string getSignedRLP() const
+        /// Signed transaction RLP. It is signed once, ahead of time if prefetchSignedRLP was called
+        std::string const& getSignedRLP() const
         {
-            u256 nonce = u256(m_data.at("nonce").asString());
-            u256 gasPrice = u256(m_data.at("gasPrice").asString());
-            u256 gasLimit = u256(m_data.at("gasLimit").asString());
-            Address trTo = Address(m_data.at("to").asString());
-            u256 value = u256(m_data.at("value").asString());
-            bytes data = fromHex(m_data.at("data").asString());
-
-            dev::RLPStream s;
-            s.appendList(6);
-            s << nonce;
-            s << gasPrice;
-            s << gasLimit;
-            if (m_data.at("to").asString().size() == 42)
-                s << trTo;
-            else
-                s << "";
-            s << value;
-            s << data;
-            h256 hash(dev::sha3(s.out()));
-            Signature sig = dev::sign(dev::Secret(m_data.at("secretKey").asString()), hash);
+            if (m_signedRLP.empty())
+            {
+                m_signedRLP = TransactionSigner::get().sign(getFields());
+                ETH_REQUIRE_MESSAGE(!m_signedRLP.empty(), TestOutputHelper::get().testName() + "Could not construct transaction signature!");
+            }
+            return m_signedRLP;
+        }
 
-            SignatureStruct sigStruct = *(SignatureStruct const*)&sig;
-            ETH_REQUIRE_MESSAGE(sigStruct.isValid(), TestOutputHelper::get().testName() + "Could not construct transaction signature!");
+        /// Start signing the transaction on a signer thread
+        void prefetchSignedRLP() const
+        {
+            if (m_signedRLP.empty())
+                TransactionSigner::get().prefetch(getFields());
+        }
 
-            RLPStream sWithSignature;
-            sWithSignature.appendList(9);
-            sWithSignature << nonce;
-            sWithSignature << gasPrice;
-            sWithSignature << gasLimit;
-            if (m_data.at("to").asString().size() == 42)
-                sWithSignature << trTo;
-            else
-                sWithSignature << "";
-            sWithSignature << value;
-            sWithSignature << data;
-            byte v = 27 + sigStruct.v;
-            sWithSignature << v;
-            sWithSignature << (u256)sigStruct.r;
-            sWithSignature << (u256)sigStruct.s;
-            return dev::toHexPrefixed(sWithSignature.out());
+        private:
+        mutable std::string m_signedRLP;
+        TransactionFields getFields() const
+        {
+            TransactionFields fields;
+            fields.nonce = m_data.at("nonce").asU256();
+            fields.gasPrice = m_data.at("gasPrice").asU256();
+            fields.gasLimit = m_data.at("gasLimit").asU256();
+            fields.creation = m_data.at("to").asString().size() != 42;
+            fields.to = m_data.at("to").asAddress();
+            fields.value = m_data.at("value").asU256();
+            fields.data = m_data.at("data").asBytes();
+            fields.secretKey = dev::Secret(m_data.at("secretKey").asString());
+            return fields;
         }
     };
 
     class scheme_generalTransaction: public object
     {
         public:
+        /// A cell of the data x gasLimit x value matrix. The transaction itself is built by
+        /// buildTransaction when the cell is executed
         struct transactionInfo
         {
-            transactionInfo(size_t _dataInd, size_t _gasInd, size_t _valueInd, DataObject const& _transaction) :
-                gasInd(_gasInd), dataInd(_dataInd), valueInd(_valueInd), executed(false), transaction(_transaction)
+            transactionInfo(size_t _dataInd, size_t _gasInd, size_t _valueInd) :
+                gasInd(_gasInd), dataInd(_dataInd), valueInd(_valueInd), executed(false)
                 {}
             size_t gasInd;
             size_t dataInd;
             size_t valueInd;
             bool executed;
-            test::scheme_transaction transaction;
         };
 
         scheme_generalTransaction(DataObject const& _transaction):
@@ -115,33 +107,80 @@ namespace test {
         std::vector<transactionInfo> const& getTransactions() const { return m_transactions; }
         std::vector<transactionInfo>& getTransactionsUnsafe() { return m_transactions; }
 
+        /// Positions in getTransactions() of the cells that an expect or post section with these
+        /// index sets is for, in the matrix order. -1 in a set stands for every index.
+        std::vector<size_t> selectTransactions(std::set<int> const& _dataIndexes,
+            std::set<int> const& _gasIndexes, std::set<int> const& _valueIndexes) const
+        {
+            std::vector<size_t> const data = selectIndexes(_dataIndexes, m_dataCount);
+            std::vector<size_t> const gas = selectIndexes(_gasIndexes, m_gasCount);
+            std::vector<size_t> const value = selectIndexes(_valueIndexes, m_valueCount);
+            std::vector<size_t> result;
+            result.reserve(data.size() * gas.size() * value.size());
+            for (size_t dataInd : data)
+                for (size_t gasInd : gas)
+                    for (size_t valueInd : value)
+                        result.push_back((dataInd * m_gasCount + gasInd) * m_valueCount + valueInd);
+            return result;
+        }
+
+        /// Build the transaction of a matrix cell
+        scheme_transaction buildTransaction(transactionInfo const& _tr) const
+        {
+            DataObject singleTransaction(DataType::Object);
+            singleTransaction.addSubObject(DataObject("data", m_data.at("data").getSubObjects().at(_tr.dataInd).asString()));
+            singleTransaction.addSubObject(DataObject("gasLimit", m_data.at("gasLimit").getSubObjects().at(_tr.gasInd).asString()));
+            singleTransaction.addSubObject(m_data.at("gasPrice"));
+            singleTransaction.addSubObject(m_data.at("nonce"));
+            singleTransaction.addSubObject(m_data.at("secretKey"));
+            singleTransaction.addSubObject(m_data.at("to"));
+            singleTransaction.addSubObject(DataObject("value", m_data.at("value").getSubObjects().at(_tr.valueInd).asString()));
+            return scheme_transaction(singleTransaction);
+        }
+
+        /// The transaction of a matrix cell, built on first use and kept with its signature
+        scheme_transaction const& getTransaction(transactionInfo const& _tr) const
+        {
+            size_t const position = (_tr.dataInd * m_gasCount + _tr.gasInd) * m_valueCount + _tr.valueInd;
+            auto it = m_builtTransactions.find(position);
+            if (it == m_builtTransactions.end())
+                it = m_builtTransactions.emplace(position, buildTransaction(_tr)).first;
+            return it->second;
+        }
+
         private:
         std::vector<transactionInfo> m_transactions;
+        mutable std::map<size_t, scheme_transaction> m_builtTransactions;  ///< by position in m_transactions
+        size_t m_dataCount;
+        size_t m_gasCount;
+        size_t m_valueCount;
         void parseGeneralTransaction()
         {
-            for (size_t dataInd = 0; dataInd < m_data.at("data").getSubObjects().size(); dataInd++)
-            {
-                for (size_t gasInd = 0; gasInd < m_data.at("gasLimit").getSubObjects().size(); gasInd++)
-                {
-                    for (size_t valueInd = 0; valueInd < m_data.at("value").getSubObjects().size(); valueInd++)
-                    {
-                        DataObject singleTransaction(DataType::Object);
-                        DataObject data("data", m_data.at("data").getSubObjects().at(dataInd).asString());
-                        DataObject gas("gasLimit", m_data.at("gasLimit").getSubObjects().at(gasInd).asString());
-                        DataObject value("value", m_data.at("value").getSubObjects().at(valueInd).asString());
+            m_dataCount = m_data.at("data").getSubObjects().size();
+            m_gasCount = m_data.at("gasLimit").getSubObjects().size();
+            m_valueCount = m_data.at("value").getSubObjects().size();
+            m_transactions.reserve(m_dataCount * m_gasCount * m_valueCount);
+            for (size_t dataInd = 0; dataInd < m_dataCount; dataInd++)
+                for (size_t gasInd = 0; gasInd < m_gasCount; gasInd++)
+                    for (size_t valueInd = 0; valueInd < m_valueCount; valueInd++)
+                        m_transactions.push_back(transactionInfo(dataInd, gasInd, valueInd));
+        }
 
-                        singleTransaction.addSubObject(data);
-                        singleTransaction.addSubObject(gas);
-                        singleTransaction.addSubObject(m_data.at("gasPrice"));
-                        singleTransaction.addSubObject(m_data.at("nonce"));
-                        singleTransaction.addSubObject(m_data.at("secretKey"));
-                        singleTransaction.addSubObject(m_data.at("to"));
-                        singleTransaction.addSubObject(value);
-                        transactionInfo info(dataInd, gasInd, valueInd, singleTransaction);
-                        m_transactions.push_back(info);
-                    }
-                }
+        static std::vector<size_t> selectIndexes(std::set<int> const& _indexes, size_t _count)
+        {
+            std::vector<size_t> result;
+            if (_indexes.count(-1))
+            {
+                for (size_t i = 0; i < _count; i++)
+                    result.push_back(i);
+            }
+            else
+            {
+                for (int i : _indexes)
+                    if (i >= 0 && size_t(i) < _count)
+                        result.push_back(i);
             }
+            return result;
         }
     };
 }
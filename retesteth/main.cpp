@@ -9,6 +9,8 @@
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/RPCSession.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/TestSharding.h>
+#include <retesteth/DistributedTests.h>
 
 using namespace boost::unit_test;
 
@@ -121,6 +123,15 @@ int main(int argc, const char* argv[])
 	}
 
 	test::Options const& opt = test::Options::get();
+	if (!opt.mergeShardFiles.empty())
+	{
+		boost::filesystem::path output;
+		if (opt.shardResultFile.is_initialized())
+			output = opt.shardResultFile.get();
+		size_t failedTests = test::TestSharding::mergeResults(opt.mergeShardFiles, output);
+		return failedTests ? 1 : 0;
+	}
+
 	if (opt.createRandomTest || opt.singleTestFile.is_initialized())
 	{
 		bool testSuiteFound = false;
@@ -170,6 +181,9 @@ int main(int argc, const char* argv[])
 		result = unit_test_main(fakeInit, argc, const_cast<char**>(argv));
         RPCSession::clear();
         test::TestOutputHelper::get().printTestExecStats();
+        test::TestSharding::get().writeResults();
+        if (opt.coordinatorPort)
+            test::TestCoordinator::get().shutdown();
 		return result;
 	}
 	else
@@ -182,6 +196,9 @@ int main(int argc, const char* argv[])
 		outputThread.join();
         RPCSession::clear();
         test::TestOutputHelper::printTestExecStats();
+        test::TestSharding::get().writeResults();
+        if (opt.coordinatorPort)
+            test::TestCoordinator::get().shutdown();
         return result;
 	}
 }
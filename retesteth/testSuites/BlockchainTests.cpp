@@ -24,6 +24,8 @@ along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 #include <retesteth/Options.h>
 #include <retesteth/RPCSession.h>
 #include <retesteth/TestOutputHelper.h>
+#include <retesteth/TestSharding.h>
+#include <retesteth/ethObjects/blockchainTest/blockRLP.h>
 #include <retesteth/ethObjects/common.h>
 #include <retesteth/testSuites/Common.h>
 #include <boost/filesystem/operations.hpp>
@@ -45,14 +47,26 @@ bool RunTest(DataObject const& _testObject)
 
     // for all blocks
     for (auto const& brlp : inputTest.getBlockRlps())
+    {
+        // Blocks are decoded before the import. A malformed block is still sent,
+        // the test checks that the client rejects it
+        bytes const blockData = fromHex(brlp);
+        blockRLP const block(&blockData);
+        if (!block.isValid())
+            ETH_TEST_MESSAGE("Block is not valid and has to be rejected: " + block.error());
+
+        dev::Timer importTimer;
         session.test_importRawBlock(brlp);
+        if (block.isValid())
+            TestOutputHelper::registerBlockImport(block.gasUsed(), importTimer.elapsed());
+    }
 
     // wait for blocks to process
     // std::this_thread::sleep_for(std::chrono::seconds(10));
 
     // compare post state hash
     DataObject remoteState = getRemoteState(session, "", true);
-    scheme_state postState(remoteState.at("postState"));
+    scheme_state postState(std::move(remoteState["postState"]));
     CompareResult res = test::compareStates(inputTest.getPost(), postState);
     ETH_CHECK_MESSAGE(res == CompareResult::Success, "Error in " + inputTest.getData().getKey());
     return (res != CompareResult::Success);
@@ -70,13 +84,24 @@ DataObject BlockchainTestSuite::doTests(DataObject const& _input, TestSuiteOptio
                                                " A BlockchainTest file should contain an object.");
 
     // A blockchain test file contains many tests in one .json file
+    // Every shard reads the whole file and runs only its own tests from it
+    set<string> shard;
+    if (_opt.shardByTestName)
+    {
+        vector<string> names;
+        for (auto const& i : _input.getSubObjects())
+            names.push_back(i.getKey());
+        shard = TestSharding::get().selectShard(names);
+    }
+
+    string const selectedTest = selectedTestName();
     for (auto const& i : _input.getSubObjects())
     {
         string const& testname = i.getKey();
-        // Select test by name if --singletest is set
-        if (!Options::get().singleTestNet.empty() && Options::get().singleTest)
-            if (testname != Options::get().singleTestName + "_" + Options::get().singleTestNet)
-                continue;
+        if (!selectedTest.empty() && testname != selectedTest)
+            continue;
+        if (_opt.shardByTestName && !shard.count(testname))
+            continue;
         TestOutputHelper::get().setCurrentTestName(testname);
 
         if (_opt.doFilling)
@@ -126,7 +151,17 @@ DataObject BlockchainTestSuite::doTests(DataObject const& _input, TestSuiteOptio
             }*/
         }
         else
+        {
+            dev::Timer executionTimer;
+            size_t const errorsBefore = TestOutputHelper::get().getErrors().size();
             _opt.wasErrors = RunTest(i);
+            if (_opt.shardByTestName)
+            {
+                vector<string> const& errors = TestOutputHelper::get().getErrors();
+                TestSharding::get().registerResult(testname, executionTimer.elapsed(),
+                    vector<string>(errors.begin() + errorsBefore, errors.end()));
+            }
+        }
     }
 
     return tests;
@@ -142,6 +177,14 @@ fs::path BlockchainTestSuite::suiteFillerFolder() const
     return "BlockchainTestsFiller";
 }
 
+string BlockchainTestSuite::selectedTestName() const
+{
+    // Filled tests are named <test>_<network>, a test is selected with --singletest and --singlenet
+    if (Options::get().singleTest && !Options::get().singleTestNet.empty())
+        return Options::get().singleTestName + "_" + Options::get().singleTestNet;
+    return string();
+}
+
 }  // Namespace Close
 
 class BlockchainTestFixture
@@ -31,5 +31,7 @@ public:
     DataObject doTests(DataObject const& _input, TestSuiteOptions& _opt) const override;
     boost::filesystem::path suiteFolder() const override;
     boost::filesystem::path suiteFillerFolder() const override;
+    bool hasManyTestsPerFile() const override { return true; }
+    std::string selectedTestName() const override;
 };
 }
@@ -9,7 +9,7 @@ DataObject getRemoteState(RPCSession& _session, string const& _trHash, bool _ful
 {
     DataObject remoteState;
     const int cmaxRows = 1000;
-    string latestBlockNumber = toString(u256(_session.eth_blockNumber()));
+    string latestBlockNumber = toString(toU256(_session.eth_blockNumber()));
 
     test::scheme_block latestBlock = _session.eth_getBlockByNumber(latestBlockNumber, true);
     remoteState["postHash"] = latestBlock.getData().at("stateRoot");
@@ -28,7 +28,7 @@ DataObject getRemoteState(RPCSession& _session, string const& _trHash, bool _ful
             // Balance
             Json::Value ret = _session.eth_getBalance(acc.asString(), latestBlockNumber);
             accountObj[acc.asString()]["balance"] =
-                dev::toCompactHexPrefixed(u256(ret.asString()), 1);  // fix odd strings
+                dev::toCompactHexPrefixed(dev::toU256(ret.asString()), 1);  // fix odd strings
 
             // Code
             ret = _session.eth_getCode(acc.asString(), latestBlockNumber);
@@ -37,7 +37,7 @@ DataObject getRemoteState(RPCSession& _session, string const& _trHash, bool _ful
             // Nonce
             ret = _session.eth_getTransactionCount(acc.asString(), latestBlockNumber);
             accountObj[acc.asString()]["nonce"] =
-                dev::toCompactHexPrefixed(u256(ret.asString()), 1);
+                dev::toCompactHexPrefixed(dev::toU256(ret.asString()), 1);
 
             // Storage
             DataObject storage(DataType::Object);
@@ -45,13 +45,13 @@ DataObject getRemoteState(RPCSession& _session, string const& _trHash, bool _ful
                 latestBlockNumber, trIndex, acc.asString(), "0", cmaxRows));
             for (auto const& element : debugStorageAt["storage"].getSubObjects())
                 storage[element.at("key").asString()] = element.at("value").asString();
-            accountObj[acc.asString()]["storage"] = storage;
+            accountObj[acc.asString()]["storage"] = std::move(storage);
         }
 
-        remoteState["postState"].clear();
-        remoteState["postState"] = accountObj;
         if (Options::get().poststate)
             std::cout << accountObj.asJson() << std::endl;
+        remoteState["postState"].clear();
+        remoteState["postState"] = std::move(accountObj);
     }
     return remoteState;
 }
@@ -54,11 +54,37 @@ bool OptionsAllowTransaction(scheme_generalTransaction::transactionInfo const& _
     return false;
 }
 
+/// Transactions that an expect or post section is for, in the matrix order
+template <class T>
+vector<scheme_generalTransaction::transactionInfo*> selectTransactions(
+    testprivate::scheme_stateTestBase& _test, T const& _section)
+{
+    vector<scheme_generalTransaction::transactionInfo*> result;
+    for (size_t i : _test.getGenTransaction().selectTransactions(
+             _section.getDataIndexes(), _section.getGasIndexes(), _section.getValueIndexes()))
+    {
+        scheme_generalTransaction::transactionInfo& tr = _test.getTransactionsUnsafe().at(i);
+        if (OptionsAllowTransaction(tr))
+            result.push_back(&tr);
+    }
+    return result;
+}
+
+/// Start signing the transactions of the sections, so the signatures are ready when they are sent
+template <class T>
+void prefetchSignatures(testprivate::scheme_stateTestBase& _test, vector<T> const& _sections)
+{
+    for (auto const& section : _sections)
+        for (auto* tr : selectTransactions(_test, section))
+            _test.getGenTransaction().getTransaction(*tr).prefetchSignedRLP();
+}
+
 /// Generate a blockchain test from state test filler
 DataObject FillTestAsBlockchain(DataObject const& _testFile, TestSuite::TestSuiteOptions& _opt)
 {
     DataObject filledTest;
     test::scheme_stateTestFiller test(_testFile);
+    prefetchSignatures(test, test.getExpectSections());
 
     RPCSession& session = RPCSession::instance(TestOutputHelper::getThreadID());
     // run transactions on all networks that we need
@@ -70,14 +96,10 @@ DataObject FillTestAsBlockchain(DataObject const& _testFile, TestSuite::TestSuit
             // if expect section for this networks
             if (expect.getNetworks().count(net))
             {
-                for (auto& tr : test.getTransactionsUnsafe())
+                // only the transactions of this expect section are built and executed
+                for (auto* trPtr : selectTransactions(test, expect))
                 {
-                    if (!OptionsAllowTransaction(tr))
-                        continue;
-
-                    // if expect section is for this transaction
-                    if (!expect.checkIndexes(tr.dataInd, tr.gasInd, tr.valueInd))
-                        continue;
+                    auto& tr = *trPtr;
 
                     // State Tests does not have mining rewards
                     scheme_expectSectionElement mexpect = expect;
@@ -86,7 +108,8 @@ DataObject FillTestAsBlockchain(DataObject const& _testFile, TestSuite::TestSuit
                     session.test_setChainParams(test.getGenesisForRPC(net, "Ethash").asJson());
                     u256 a(test.getEnv().getData().at("currentTimestamp").asString());
                     session.test_modifyTimestamp(a.convert_to<size_t>());
-                    string signedTransactionRLP = tr.transaction.getSignedRLP();
+                    string signedTransactionRLP =
+                        test.getGenTransaction().getTransaction(tr).getSignedRLP();
                     string trHash = session.eth_sendRawTransaction(signedTransactionRLP);
                     session.test_mineBlocks(1);
                     tr.executed = true;
@@ -109,7 +132,7 @@ DataObject FillTestAsBlockchain(DataObject const& _testFile, TestSuite::TestSuit
                         aBlockchainTest["_info"] = test.getData().at("_info");
                     aBlockchainTest["genesisBlockHeader"] = test.getEnv().getDataForRPC();
                     aBlockchainTest["pre"] = test.getPre().getData();
-                    aBlockchainTest["postState"] = remoteState.at("postState");
+                    aBlockchainTest["postState"] = std::move(remoteState["postState"]);
                     aBlockchainTest["network"] = net;
 
                     test::scheme_block blockData(remoteState.at("rawBlockData"));
@@ -122,12 +145,12 @@ DataObject FillTestAsBlockchain(DataObject const& _testFile, TestSuite::TestSuit
 
                     DataObject block;
                     block["rlp"] = blockData.getBlockRLP();
-                    aBlockchainTest["blocks"].addArrayObject(block);
+                    aBlockchainTest["blocks"].addArrayObject(std::move(block));
 
                     string dataPostfix = "_d" + toString(tr.dataInd) + "g" + toString(tr.gasInd) +
                                          "v" + toString(tr.valueInd);
                     dataPostfix += "_" + net;
-                    filledTest[_testFile.getKey() + dataPostfix] = aBlockchainTest;
+                    filledTest[_testFile.getKey() + dataPostfix] = std::move(aBlockchainTest);
                     session.test_rewindToBlock(0);
                 }
             }
@@ -142,6 +165,7 @@ DataObject FillTest(DataObject const& _testFile, TestSuite::TestSuiteOptions& _o
 {
     DataObject filledTest;
     test::scheme_stateTestFiller test(_testFile);
+    prefetchSignatures(test, test.getExpectSections());
 
     RPCSession& session = RPCSession::instance(TestOutputHelper::getThreadID());
     if (test.getData().count("_info"))
@@ -163,25 +187,21 @@ DataObject FillTest(DataObject const& _testFile, TestSuite::TestSuiteOptions& _o
             // if expect section for this networks
             if (expect.getNetworks().count(net))
             {
-                for (auto& tr : test.getTransactionsUnsafe())
+                // only the transactions of this expect section are built and executed
+                for (auto* trPtr : selectTransactions(test, expect))
                 {
-                    if (!OptionsAllowTransaction(tr))
-                        continue;
-
-                    // if expect section is for this transaction
-                    if (!expect.checkIndexes(tr.dataInd, tr.gasInd, tr.valueInd))
-                        continue;
-
+                    auto& tr = *trPtr;
                     u256 a(test.getEnv().getData().at("currentTimestamp").asString());
                     session.test_modifyTimestamp(a.convert_to<size_t>());
-                    string trHash = session.eth_sendRawTransaction(tr.transaction.getSignedRLP());
+                    string trHash = session.eth_sendRawTransaction(
+                        test.getGenTransaction().getTransaction(tr).getSignedRLP());
                     session.test_mineBlocks(1);
                     tr.executed = true;
 
                     DataObject remoteState = getRemoteState(session, trHash, true);
 
                     // check that the post state qualifies to the expect section
-                    scheme_state postState(remoteState.at("postState"));
+                    scheme_state postState(std::move(remoteState["postState"]));
                     CompareResult res = test::compareStates(expect.getExpectState(), postState);
                     ETH_CHECK_MESSAGE(res == CompareResult::Success,
                         "Network: " + net + ", TrInfo: d: " + toString(tr.dataInd) +
@@ -195,17 +215,17 @@ DataObject FillTest(DataObject const& _testFile, TestSuite::TestSuiteOptions& _o
                     indexes["gas"] = tr.gasInd;
                     indexes["value"] = tr.valueInd;
 
-                    transactionResults["indexes"] = indexes;
+                    transactionResults["indexes"] = std::move(indexes);
                     transactionResults["hash"] = remoteState.at("postHash").asString();
                     if (remoteState.count("logHash"))
                         transactionResults["logs"] = remoteState.at("logHash").asString();
-                    forkResults.addArrayObject(transactionResults);
+                    forkResults.addArrayObject(std::move(transactionResults));
                     session.test_rewindToBlock(0);
                 }
             }
         }
         test.checkUnexecutedTransactions();
-        filledTest["post"].addSubObject(forkResults);
+        filledTest["post"].addSubObject(std::move(forkResults));
     }
     return filledTest;
 }
@@ -214,6 +234,11 @@ DataObject FillTest(DataObject const& _testFile, TestSuite::TestSuiteOptions& _o
 void RunTest(DataObject const& _testFile)
 {
     test::scheme_stateTest test(_testFile);
+    for (auto const& post : test.getPost().getResults())
+    {
+        if (Options::get().singleTestNet.empty() || Options::get().singleTestNet == post.first)
+            prefetchSignatures(test, post.second);
+    }
     RPCSession& session = RPCSession::instance(TestOutputHelper::getThreadID());
 
 	// read post state results
@@ -229,54 +254,46 @@ void RunTest(DataObject const& _testFile)
         for (auto const& result: post.second)
         {
 			// look for a transaction with this indexes and execute it on a client
-            for (auto& tr: test.getTransactionsUnsafe())
+            for (auto* trPtr : selectTransactions(test, result))
 			{
-				if (!OptionsAllowTransaction(tr))
-					continue;
-
-				bool blockMined = false;
-                if (result.checkIndexes(tr.dataInd, tr.gasInd, tr.valueInd))
-                {
-                    string testInfo = TestOutputHelper::get().testName() + ", fork: " + network
-                                    + ", TrInfo: d: " + toString(tr.dataInd) + ", g: " + toString(tr.gasInd)
-                                    + ", v: " + toString(tr.valueInd);
-                    u256 a(test.getEnv()
-                               .getData()
-                               .at("currentTimestamp")
-                               .asString());
-                    session.test_modifyTimestamp(a.convert_to<size_t>());
-                    string trHash = session.eth_sendRawTransaction(
-                        tr.transaction.getSignedRLP());
-                    session.test_mineBlocks(1);
-                    tr.executed = true;
-                    blockMined = true;
+                auto& tr = *trPtr;
+                string testInfo = TestOutputHelper::get().testName() + ", fork: " + network
+                                + ", TrInfo: d: " + toString(tr.dataInd) + ", g: " + toString(tr.gasInd)
+                                + ", v: " + toString(tr.valueInd);
+                u256 a(test.getEnv()
+                           .getData()
+                           .at("currentTimestamp")
+                           .asString());
+                session.test_modifyTimestamp(a.convert_to<size_t>());
+                string trHash = session.eth_sendRawTransaction(
+                    test.getGenTransaction().getTransaction(tr).getSignedRLP());
+                session.test_mineBlocks(1);
+                tr.executed = true;
+
+                DataObject remoteState =
+                    getRemoteState(session, trHash, false);
+                string expectHash = result.getData().at("hash").asString();
+                string expectLogHash =
+                    result.getData().at("logs").asString();
+                if (remoteState.at("postHash").asString() != expectHash) {
+                  remoteState.clear();
+                  remoteState = getRemoteState(session, trHash, true);
+                }
 
-                    DataObject remoteState =
-                        getRemoteState(session, trHash, false);
-                    string expectHash = result.getData().at("hash").asString();
-                    string expectLogHash =
-                        result.getData().at("logs").asString();
-                    if (remoteState.at("postHash").asString() != expectHash) {
-                      remoteState.clear();
-                      remoteState = getRemoteState(session, trHash, true);
-					}
-
-                    ETH_CHECK_MESSAGE(remoteState.at("postHash").asString() == expectHash,
-                        "Error at " + testInfo + ", post hash mismatch: " +
-                            remoteState.at("postHash").asString() + ", expected: " + expectHash);
-                    if (remoteState.at("postHash").asString() != expectHash)
-                        ETH_TEST_MESSAGE("\nState Dump: \n" + remoteState.at("postState").asJson());
+                ETH_CHECK_MESSAGE(remoteState.at("postHash").asString() == expectHash,
+                    "Error at " + testInfo + ", post hash mismatch: " +
+                        remoteState.at("postHash").asString() + ", expected: " + expectHash);
+                if (remoteState.at("postHash").asString() != expectHash)
+                    ETH_TEST_MESSAGE("\nState Dump: \n" + remoteState.at("postState").asJson());
 
-                    if (remoteState.count("logHash"))
-                    {
-                        ETH_CHECK_MESSAGE(remoteState.at("logHash").asString() == expectLogHash,
-                            "Error at " + testInfo +
-                                ", logs hash mismatch: " + remoteState.at("logHash").asString() +
-                                ", expected: " + expectLogHash);
-                    }
+                if (remoteState.count("logHash"))
+                {
+                    ETH_CHECK_MESSAGE(remoteState.at("logHash").asString() == expectLogHash,
+                        "Error at " + testInfo +
+                            ", logs hash mismatch: " + remoteState.at("logHash").asString() +
+                            ", expected: " + expectLogHash);
                 }
-                if (blockMined)
-					session.test_rewindToBlock(0);
+                session.test_rewindToBlock(0);
 			}
 		}
 
@@ -317,14 +334,11 @@ DataObject StateTestSuite::doTests(DataObject const& _input, TestSuiteOptions& _
         {
             // Each transaction will produce many tests
             outputTest = FillTestAsBlockchain(inputTest, _opt);
-            for (auto const& obj : outputTest.getSubObjects())
-                filledTest.addSubObject(obj);
+            for (auto& obj : outputTest.getSubObjectsUnsafe())
+                filledTest.addSubObject(std::move(obj));
         }
         else
-        {
-            outputTest[testname] = FillTest(inputTest, _opt);
-            filledTest = outputTest;
-        }
+            filledTest.addSubObject(testname, FillTest(inputTest, _opt));
     }
     else
     {
@@ -18,8 +18,12 @@
  * Unit tests for ethObjects functions.
  */
 
+#include <retesteth/BinaryTestCache.h>
+#include <retesteth/ethObjects/blockchainTest/blockRLP.h>
 #include <retesteth/ethObjects/common.h>
+#include <libdevcore/RLPWriter.h>
 #include <retesteth/TestOutputHelper.h>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/test/unit_test.hpp>
 #include <thread>
 
@@ -29,6 +33,122 @@ using namespace test;
 
 BOOST_FIXTURE_TEST_SUITE(EthObjectsSuite, TestOutputHelperFixture)
 
+BOOST_AUTO_TEST_CASE(dataobject_keyIndex)
+{
+	// Enough keys for the hash index
+	DataObject data;
+	for (size_t i = 0; i < 100; i++)
+		data["key" + toString(i)] = "data" + toString(i);
+	BOOST_CHECK(data.count("key50"));
+	BOOST_CHECK(!data.count("key100"));
+	BOOST_CHECK(data.at("key99").asString() == "data99");
+
+	data["key100"] = "data100";
+	BOOST_CHECK(data.count("key100"));
+	BOOST_CHECK(data.getSubObjects().at(100).getKey() == "key100");
+
+	data.renameKey("key10", "renamed");
+	BOOST_CHECK(!data.count("key10"));
+	BOOST_CHECK(data.at("renamed").asString() == "data10");
+	BOOST_CHECK(data.getSubObjects().at(10).getKey() == "renamed");
+
+	data.removeKey("key5");
+	BOOST_CHECK(!data.count("key5"));
+	BOOST_CHECK(data.at("key6").asString() == "data6");
+	BOOST_CHECK(data.getSubObjects().at(5).getKey() == "key6");
+
+	data.setKeyPos("key100", 0);
+	BOOST_CHECK(data.at("key100").asString() == "data100");
+	BOOST_CHECK(data.at("key0").asString() == "data0");
+	BOOST_CHECK(data.getSubObjects().at(0).getKey() == "key100");
+
+	DataObject copy = data;
+	BOOST_CHECK(copy.at("key99").asString() == "data99");
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_moveSubObjects)
+{
+	DataObject data;
+	DataObject& account = data.emplaceSubObject("account", DataType::Object);
+	account["balance"] = "0x01";
+	DataObject storage(DataType::Object);
+	storage["0x00"] = "0x02";
+	account.addSubObject("storage", std::move(storage));
+	DataObject array;
+	array.addArrayObject(DataObject("element"));
+	data["array"] = std::move(array);
+	BOOST_CHECK(data.at("account").at("storage").at("0x00").asString() == "0x02");
+	BOOST_CHECK(data.at("array").getSubObjects().at(0).asString() == "element");
+	BOOST_CHECK(data.getSubObjects().at(1).getKey() == "array");
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_asJsonStream)
+{
+	DataObject data;
+	data["nonce"] = "0x00";
+	data["number"] = 1;
+	data["storage"] = DataObject(DataType::Object);
+	data["array"].addArrayObject(DataObject("0x01"));
+	data["array"].addArrayObject(DataObject(DataType::Bool, false));
+	std::ostringstream compact;
+	data.asJson(compact, 0, false);
+	BOOST_CHECK(compact.str() ==
+				"{\"nonce\":\"0x00\",\"number\":1,\"storage\":{},\"array\":[\"0x01\",false]}");
+	std::ostringstream pretty;
+	data.asJson(pretty);
+	BOOST_CHECK(pretty.str() == data.asJson());
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_typedViews)
+{
+	DataObject data;
+	data["balance"] = "0x0100";
+	data["nonce"] = "256";
+	data["number"] = 1;
+	data["code"] = "0x6001";
+	data["to"] = "0x095e7baea6a6c7c4c2dfeb977efac326af552d87";
+	BOOST_CHECK(data.at("balance").asU256() == 256);
+	BOOST_CHECK(data.at("balance").asU256() == data.at("nonce").asU256());
+	BOOST_CHECK(data.at("number").asU256() == 1);
+	BOOST_CHECK(data.at("code").asBytes() == bytes({0x60, 0x01}));
+	BOOST_CHECK(data.at("to").asAddress() == Address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87"));
+
+	// The cached view follows the value
+	data["balance"].clear();
+	data["balance"] = "0x02";
+	BOOST_CHECK(data.at("balance").asU256() == 2);
+	data["code"].replace(DataObject("code", "0x"));
+	BOOST_CHECK(data.at("code").asBytes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_binaryRoundTrip)
+{
+	DataObject data;
+	data["pre"]["0x095e7baea6a6c7c4c2dfeb977efac326af552d87"]["balance"] = "0x0de0b6b3a7640000";
+	data["pre"]["0x095e7baea6a6c7c4c2dfeb977efac326af552d87"]["storage"] = DataObject(DataType::Object);
+	data["pre"]["0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b"]["balance"] = "0x00";
+	data["number"] = -300;
+	data["flag"] = DataObject(DataType::Bool, true);
+	data["null"] = DataObject(DataType::Null);
+	data["array"].addArrayObject(DataObject("0x01"));
+	data["array"].addArrayObject(DataObject(DataType::Array));
+
+	string binary;
+	writeBinaryData(data, binary);
+	DataObject restored;
+	BOOST_REQUIRE(readBinaryData(binary.data(), binary.size(), restored));
+	BOOST_CHECK(restored.asJson() == data.asJson());
+	BOOST_CHECK(restored.at("number").asInt() == -300);
+
+	// Truncated or damaged data is rejected and the output is not touched
+	DataObject broken;
+	for (size_t size = 0; size < binary.size(); size++)
+		BOOST_CHECK(!readBinaryData(binary.data(), size, broken));
+	binary[0] = char(0x7F);
+	BOOST_CHECK(!readBinaryData(binary.data(), binary.size(), broken));
+	BOOST_CHECK(broken.type() == DataType::Null);
+}
+
 BOOST_AUTO_TEST_CASE(dataobject_setKeyPos_lastToFirst)
 {
 	DataObject data;
@@ -237,6 +357,83 @@ BOOST_AUTO_TEST_CASE(object_stringIntegerType_otherTypes)
 	BOOST_CHECK(object::stringIntegerType("11223344abcdeffzz") == object::DigitsType::String);
 }
 
+BOOST_AUTO_TEST_CASE(object_stringIntegerType_edgeCases)
+{
+	string const longHex = "0123456789abcdefABCDEF0123456789abcdefABCDEF0123456789abcdef";
+	BOOST_CHECK(object::stringIntegerType("") == object::DigitsType::Decimal);
+	BOOST_CHECK(object::stringIntegerType("0x") == object::DigitsType::HexPrefixed);
+	BOOST_CHECK(object::stringIntegerType("0x0x12") == object::DigitsType::String);
+	BOOST_CHECK(object::stringIntegerType("0X12") == object::DigitsType::String);
+	BOOST_CHECK(object::stringIntegerType(longHex) == object::DigitsType::Hex);
+	BOOST_CHECK(object::stringIntegerType("0x" + longHex) == object::DigitsType::HexPrefixed);
+	BOOST_CHECK(object::stringIntegerType(string(100, '7')) == object::DigitsType::Decimal);
+	BOOST_CHECK(object::stringIntegerType(longHex + "g") == object::DigitsType::String);
+	BOOST_CHECK(object::stringIntegerType(string(40, '1') + "\xff" + string(40, '1')) == object::DigitsType::String);
+}
+
+BOOST_AUTO_TEST_CASE(object_makeAllFieldsHex_storageHeavyState)
+{
+	// 100 accounts with 200 storage slots, keys and values given in every supported format
+	DataObject pre;
+	for (size_t i = 0; i < 100; i++)
+	{
+		DataObject& account = pre[toHexPrefixed(Address(i + 1))];
+		account["balance"] = toString(i * 1000);
+		account["code"] = "";
+		account["nonce"] = "0";
+		DataObject& storage = account["storage"];
+		storage = DataObject(DataType::Object);
+		for (size_t j = 0; j < 200; j++)
+		{
+			string const key = j % 2 ? toString(j) : toCompactHex(u256(j + 0xa00));
+			storage[key] = j % 3 ? toCompactHexPrefixed(u256(j), 1) : toHex(h256(j * 16 + 0xb).asBytes());
+		}
+	}
+
+	dev::Timer timer;
+	scheme_state state(std::move(pre));
+	ETH_TEST_MESSAGE("Normalized storage heavy state in " + toString(timer.elapsed()) + " s");
+
+	DataObject const& storage = state.getData().at(toHexPrefixed(Address(1))).at("storage");
+	BOOST_CHECK(storage.getSubObjects().size() == 200);
+	BOOST_CHECK(storage.at("0x0a00").asString() == "0x0b");
+	BOOST_CHECK(storage.at("1").asString() == "0x01");
+	BOOST_CHECK(storage.at("0x0a06").asString() == "0x6b");
+	BOOST_CHECK(state.getData().at(toHexPrefixed(Address(3))).at("balance").asString() == "0x07d0");
+}
+
+BOOST_AUTO_TEST_CASE(generalTransaction_selectTransactions)
+{
+	DataObject transaction;
+	transaction["data"].addArrayObject(DataObject("0x01"));
+	transaction["data"].addArrayObject(DataObject("0x02"));
+	transaction["data"].addArrayObject(DataObject("0x03"));
+	transaction["gasLimit"].addArrayObject(DataObject("400000"));
+	transaction["gasLimit"].addArrayObject(DataObject("500000"));
+	transaction["gasPrice"] = "1";
+	transaction["nonce"] = "0";
+	transaction["secretKey"] = "0x45a915e4d060149eb4365960e6a7a45f334393093061116b197e3240065ff2d8";
+	transaction["to"] = "0x095e7baea6a6c7c4c2dfeb977efac326af552d87";
+	transaction["value"].addArrayObject(DataObject("0"));
+	transaction["value"].addArrayObject(DataObject("10"));
+	scheme_generalTransaction general(transaction);
+	BOOST_CHECK(general.getTransactions().size() == 12);
+
+	// d: all, g: 1, v: 0 and an index that is out of range
+	vector<size_t> const cells = general.selectTransactions({-1}, {1}, {0, 5});
+	BOOST_REQUIRE(cells.size() == 3);
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		auto const& tr = general.getTransactions().at(cells[i]);
+		BOOST_CHECK(tr.dataInd == i && tr.gasInd == 1 && tr.valueInd == 0);
+	}
+
+	scheme_transaction const built = general.buildTransaction(general.getTransactions().at(cells[2]));
+	BOOST_CHECK(built.getData().at("data").asString() == "0x03");
+	BOOST_CHECK(built.getData().at("gasLimit").asString() == "0x07a120");
+	BOOST_CHECK(built.getData().at("value").asString() == "0x00");
+}
+
 BOOST_AUTO_TEST_CASE(compareStates_noError)
 {
     DataObject expectData;
@@ -354,4 +551,113 @@ BOOST_AUTO_TEST_CASE(compareStates_accountShouldNotExistAndItsNot)
 	ETH_REQUIRE(res == CompareResult::Success);
 }
 
+BOOST_AUTO_TEST_CASE_EXPECTED_FAILURES(compareStates_malformedAddress, 1)
+BOOST_AUTO_TEST_CASE(compareStates_malformedAddress)
+{
+	std::cout << "Expected 1 error: " << std::endl;
+	// A key that is not an address matches neither the zero address nor other malformed keys
+	DataObject postData;
+	for (string const& address : vector<string>{"0x0000000000000000000000000000000000000000", "0xa94f"})
+	{
+		postData[address]["balance"] = "0x82124";
+		postData[address]["code"] = "0x1234";
+		postData[address]["nonce"] = "0x01";
+		postData[address]["storage"] = DataObject(DataType::Object);
+	}
+	scheme_state const post(postData);
+	ETH_REQUIRE(post.hasAccount("0x0000000000000000000000000000000000000000"));
+	ETH_REQUIRE(post.hasAccount("0xa94f"));
+	ETH_REQUIRE(!post.hasAccount("0xb94f"));
+	ETH_REQUIRE(!post.hasAccount("0x000000000000000000000000000000000000000g"));
+	ETH_REQUIRE(post.getAccount("0xa94f").getData().getKey() == "0xa94f");
+
+	DataObject expectData;
+	expectData["0xb94f"]["shouldnotexist"] = "1";
+	CompareResult res = test::compareStates(scheme_expectState(expectData), post);
+	ETH_REQUIRE(res == CompareResult::Success);
+}
+
+BOOST_AUTO_TEST_CASE(compareStates_largeState)
+{
+	// Accounts and storage slots are matched by value, not by their hex spelling
+	size_t const accounts = 20000;
+	DataObject expectData;
+	DataObject postData;
+	for (size_t i = 0; i < accounts; i++)
+	{
+		Address const address(i * 0xabcdef + 1);
+		DataObject& post = postData[toHexPrefixed(address)];
+		post["balance"] = toCompactHexPrefixed(u256(i), 1);
+		post["code"] = "0x";
+		post["nonce"] = "0x00";
+		post["storage"]["0x01"] = toCompactHexPrefixed(u256(i), 1);
+
+		if (i % 2)
+			continue;
+		string const upperCase = "0x" + boost::algorithm::to_upper_copy(toHex(address));
+		DataObject& expect = expectData[upperCase];
+		expect["balance"] = toCompactHexPrefixed(u256(i), 1);
+		expect["storage"][toHexPrefixed(h256(1))] = toCompactHexPrefixed(u256(i), 1);
+	}
+	dev::Timer timer;
+	CompareResult res = test::compareStates(scheme_expectState(expectData), scheme_state(postData));
+	ETH_TEST_MESSAGE("Compared " + toString(accounts) + " accounts in " + toString(timer.elapsed()) + " s");
+	ETH_REQUIRE(res == CompareResult::Success);
+}
+
+BOOST_AUTO_TEST_CASE(blockRLP_decode)
+{
+	auto const header = [](RLPWriter& _w, u256 const& _number, size_t _fields) {
+		_w.appendList();
+		_w << h256(1) << h256(2) << h160(3) << h256(4) << h256(5) << h256(6) << h2048();
+		_w << u256(0x20000) << _number << u256(3141592) << u256(21000) << u256(1000);
+		_w << bytes(32, 0x11) << h256(7);
+		if (_fields == 15)
+			_w << h64(8);
+		_w.endList();
+	};
+	auto const block = [&header](size_t _headerFields, size_t _transactionFields) {
+		return rlpEncode([&](RLPWriter& _w) {
+			_w.appendList();
+			header(_w, 1, _headerFields);
+			_w.appendList();
+			for (size_t i = 0; i < 2; i++)
+			{
+				_w.appendList();
+				for (size_t j = 0; j < _transactionFields; j++)
+					_w << u256(j);
+				_w.endList();
+			}
+			_w.endList();
+			_w.appendList();
+			header(_w, 0, 15);
+			_w.endList();
+			_w.endList();
+		});
+	};
+
+	bytes const valid = block(15, 9);
+	blockRLP const decoded(&valid);
+	ETH_REQUIRE_MESSAGE(decoded.isValid(), decoded.error());
+	ETH_REQUIRE(decoded.parentHash() == h256(1));
+	ETH_REQUIRE(decoded.number() == 1);
+	ETH_REQUIRE(decoded.gasLimit() == 3141592);
+	ETH_REQUIRE(decoded.gasUsed() == 21000);
+	ETH_REQUIRE(decoded.timestamp() == 1000);
+	ETH_REQUIRE(decoded.transactionCount() == 2);
+	ETH_REQUIRE(decoded.uncleCount() == 1);
+	// the fields point into the given bytes
+	ETH_REQUIRE(decoded.header().data().data() > valid.data());
+	ETH_REQUIRE(decoded.header().data().data() < valid.data() + valid.size());
+
+	bytes truncated = valid;
+	truncated.pop_back();
+	bytes trailing = valid;
+	trailing.push_back(0);
+	bytes inner = valid;
+	inner[5] += 1;  // the header claims a byte of the transaction list
+	for (bytes const& invalid : {block(14, 9), block(15, 8), truncated, trailing, inner, bytes()})
+		ETH_REQUIRE(!blockRLP(&invalid).isValid());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,9 +18,23 @@
  * Unit tests for TestHelper functions.
  */
 
+#include <retesteth/DistributedTests.h>
+#include <retesteth/JsonParser.h>
+#include <retesteth/LLLCompiler.h>
+#include <retesteth/TestFileLoader.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
+#include <retesteth/TestSharding.h>
+#include <retesteth/TransactionSigner.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/RLPWriter.h>
+#include <libdevcore/SHA3.h>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/test/unit_test.hpp>
+#include <json/reader.h>
+#include <random>
+#include <thread>
 
 using namespace std;
 using namespace dev;
@@ -97,5 +111,581 @@ BOOST_AUTO_TEST_CASE(translateNetworks_leFrontier)
     }
 }
 
+BOOST_AUTO_TEST_CASE(parseJsonData_sameAsJsoncpp)
+{
+    string const json = R"({
+        // comment
+        "pre" : { "b" : "0x01", "a" : [ 1, -2, true, false, null, {} ] },
+        "escaped" : "\"\\\/\n\u00e9\ud83d\ude00",
+        "exp" : 1e2
+    })";
+    Json::Value v;
+    ETH_REQUIRE(Json::Reader().parse(json, v));
+    string error;
+    DataObject const data = parseJsonData(json, error);
+    ETH_REQUIRE(error.empty());
+    ETH_REQUIRE(data.asJson() == convertJsonCPPtoData(v).asJson());
+    ETH_REQUIRE(data.getSubObjects().at(0).getKey() == "escaped");
+}
+
+BOOST_AUTO_TEST_CASE(parseJsonData_errors)
+{
+    for (string const json : {"{\"a\" : 1, \"a\" : 2}", "[1,]", "{\"a\" 1}", "\"abc", "1.5",
+             "3000000000", "[1] 2", "{\"a\" : \"\\q\"}", "/* comment"})
+    {
+        string error;
+        DataObject const data = parseJsonData(json, error);
+        ETH_REQUIRE(!error.empty());
+        ETH_REQUIRE(data.type() == DataType::Null);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parseJsonData_memberFilter)
+{
+    string const json = R"({
+        "test1" : { "rlp" : "0x\"}{", "blocks" : [ [], { "a" : /* } */ 1 } ] },
+        "test2" : { "b" : "0x02", "a" : [ 1, true ] },
+        "test3" : 5
+    })";
+    auto const onlyTest2 = [](string const& _key) { return _key == "test2"; };
+    string error;
+    DataObject const data = parseJsonData(json, error, onlyTest2);
+    ETH_REQUIRE(error.empty());
+    ETH_REQUIRE(data.getSubObjects().size() == 1);
+    ETH_REQUIRE(data.at("test2").asJson() == parseJsonData(json, error).at("test2").asJson());
+
+    // Skipped members still have to be well formed
+    for (string const bad : {"{\"a\" : [1, 2}", "{\"a\" : {\"b\" : \"x}}", "{\"a\" : [[]"})
+    {
+        DataObject const result = parseJsonData(bad, error, onlyTest2);
+        ETH_REQUIRE(!error.empty());
+        ETH_REQUIRE(result.type() == DataType::Null);
+    }
+}
+
+namespace
+{
+/// Check that _signedRLP is _tr signed by its secret key
+bool isSignedTransaction(string const& _signedRLP, TransactionFields const& _tr)
+{
+    bytes const rlpData = fromHex(_signedRLP);
+    RLP const rlp(rlpData);
+    if (!rlp.isList() || rlp.itemCount() != 9 || rlp[0].toInt<u256>() != _tr.nonce ||
+        rlp[5].toBytes() != _tr.data)
+        return false;
+    SignatureStruct const sig(
+        rlp[7].toHash<h256>(), rlp[8].toHash<h256>(), byte(rlp[6].toInt<unsigned>() - 27));
+    return toAddress(recover(sig, TransactionSigner::unsignedHash(_tr))) ==
+           toAddress(_tr.secretKey);
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(transactionSigner_signOnce)
+{
+    TransactionFields tr;
+    tr.nonce = 0;
+    tr.gasPrice = 1;
+    tr.gasLimit = 400000;
+    tr.creation = false;
+    tr.to = Address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87");
+    tr.value = 100000;
+    tr.data = fromHex("0x00112233");
+    tr.secretKey = Secret("0x45a915e4d060149eb4365960e6a7a45f334393093061116b197e3240065ff2d8");
+
+    string const signedRLP = TransactionSigner::get().sign(tr);
+    ETH_REQUIRE(isSignedTransaction(signedRLP, tr));
+    ETH_REQUIRE(TransactionSigner::get().sign(tr) == signedRLP);
+
+    // Prefetched transactions are signed on the signer threads
+    vector<TransactionFields> transactions;
+    for (size_t i = 1; i <= 64; i++)
+    {
+        tr.nonce = i;
+        tr.creation = i % 2;
+        transactions.push_back(tr);
+        TransactionSigner::get().prefetch(tr);
+    }
+    for (auto const& prefetched : transactions)
+    {
+        string const result = TransactionSigner::get().sign(prefetched);
+        ETH_REQUIRE(isSignedTransaction(result, prefetched));
+        ETH_REQUIRE(result != signedRLP);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rlpWriter_sameAsRLPStream)
+{
+    // short and long data, numbers of every size and nested, empty and long lists
+    vector<bytes> data = {bytes(), bytes(1, 0x00), bytes(1, 0x7f), bytes(1, 0x80), bytes(55, 0xab),
+        bytes(56, 0xcd), bytes(256, 0xef), bytes(70000, 0x01)};
+    vector<u256> numbers = {0, 1, 0x7f, 0x80, 0xff, 0x100, u256(1) << 255, ~u256(0)};
+    h160 const address("0x095e7baea6a6c7c4c2dfeb977efac326af552d87");
+    byte const v = 28;
+
+    RLPStream stream;
+    stream.appendList(4);
+    stream.appendList(data.size());
+    for (auto const& d : data)
+        stream << d;
+    stream.appendList(numbers.size() + 2);
+    for (auto const& n : numbers)
+        stream << n;
+    stream << v << address;
+    stream.appendList(0);
+    stream.appendList(1);
+    stream.appendList(data.size());
+    for (auto const& d : data)
+        stream << d;
+
+    auto const items = [&](RLPWriter& _w) {
+        _w.appendList();
+        _w.appendList();
+        for (auto const& d : data)
+            _w << d;
+        _w.endList();
+        _w.appendList();
+        for (auto const& n : numbers)
+            _w << n;
+        _w << v << address;
+        _w.endList();
+        _w.appendList();
+        _w.endList();
+        _w.appendList();
+        _w.appendList();
+        for (auto const& d : data)
+            _w << d;
+        _w.endList();
+        _w.endList();
+        _w.endList();
+    };
+    ETH_REQUIRE(rlpEncode(items) == stream.out());
+    ETH_REQUIRE(rlpEncodeHexPrefixed(items) == toHexPrefixed(stream.out()));
+    bytes buffer;
+    ETH_REQUIRE(rlpEncodeInto(items, buffer) == stream.out().size());
+    ETH_REQUIRE(buffer == stream.out());
+
+    // the writing pass has to append the measured items
+    RLPWriter w;
+    w << u256(1);
+    buffer.resize(w.size());
+    w.startWriting(buffer.data());
+    BOOST_CHECK_THROW(w << u256(1) << u256(2), RLPException);
+}
+
+namespace
+{
+/// fromHex before the vectorised version, one character at a time
+bool scalarFromHex(string const& _s, bytes& o_data)
+{
+    o_data.clear();
+    size_t s = (_s.size() >= 2 && _s[0] == '0' && _s[1] == 'x') ? 2 : 0;
+    auto const value = [](char _c) {
+        if (_c >= '0' && _c <= '9')
+            return _c - '0';
+        if (_c >= 'a' && _c <= 'f')
+            return _c - 'a' + 10;
+        if (_c >= 'A' && _c <= 'F')
+            return _c - 'A' + 10;
+        return -1;
+    };
+    if (_s.size() % 2)
+    {
+        if (value(_s[s]) == -1)
+            return false;
+        o_data.push_back(value(_s[s++]));
+    }
+    for (; s < _s.size(); s += 2)
+    {
+        if (value(_s[s]) == -1 || value(_s[s + 1]) == -1)
+            return false;
+        o_data.push_back(value(_s[s]) * 16 + value(_s[s + 1]));
+    }
+    return true;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(hex_sameAsScalar)
+{
+    // Random sizes cover the vector blocks and the tails, the odd start covers unaligned data
+    std::mt19937 random(7);
+    string const badChars = string("/:@G`gx \xff\xb0\xe1", 11) + '\0';
+    for (size_t round = 0; round < 5000; round++)
+    {
+        bytes data(random() % 300 + 1);
+        for (auto& b : data)
+            b = byte(random());
+        bytesConstRef const ref(data.data() + 1, data.size() - 1);
+
+        string const hex = toHex(ref);
+        ETH_REQUIRE(hex == toHex(ref.begin(), ref.end(), ""));
+        ETH_REQUIRE(toHexPrefixed(ref.toBytes()) == "0x" + hex);
+        ETH_REQUIRE(fromHex(hex) == ref.toBytes());
+        ETH_REQUIRE(fromHex("0x" + boost::to_upper_copy(hex)) == ref.toBytes());
+
+        if (hex.empty())
+            continue;
+
+        // odd length, and a bad character at a random position
+        string const odd = "0x" + hex.substr(1);
+        bytes expected;
+        ETH_REQUIRE(scalarFromHex(odd, expected));
+        ETH_REQUIRE(fromHex(odd) == expected);
+        string bad = hex;
+        size_t const position = random() % bad.size();
+        if (position == 1 && bad[0] == '0')
+            continue;  // "0x" is the prefix
+        bad[position] = badChars[random() % badChars.size()];
+        ETH_REQUIRE(!scalarFromHex(bad, expected));
+        ETH_REQUIRE(fromHex(bad).empty());
+        BOOST_CHECK_THROW(fromHex(bad, WhenError::Throw), BadHexCharacter);
+    }
+
+    // every byte value as a digit
+    for (int c = 0; c < 256; c++)
+    {
+        string const hex = string(64, '0') + char(c) + string(63, 'a');
+        bytes expected;
+        bool const valid = scalarFromHex(hex, expected);
+        ETH_REQUIRE(fromHex(hex) == (valid ? expected : bytes()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hex_throughput)
+{
+    bytes data(8 * 1024 * 1024);
+    std::mt19937 random(11);
+    for (auto& b : data)
+        b = byte(random());
+    double const megabytes = data.size() / 1024.0 / 1024.0;
+
+    dev::Timer timer;
+    string const scalarHex = toHex(data.begin(), data.end(), "");
+    double const scalarEncode = timer.elapsed();
+    timer.restart();
+    bytes scalarData;
+    ETH_REQUIRE(scalarFromHex(scalarHex, scalarData));
+    double const scalarDecode = timer.elapsed();
+
+    timer.restart();
+    string const hex = toHex(data);
+    double const encode = timer.elapsed();
+    timer.restart();
+    bytes const decoded = fromHex(hex);
+    double const decode = timer.elapsed();
+
+    ETH_REQUIRE(hex == scalarHex);
+    ETH_REQUIRE(decoded == data);
+    ETH_TEST_MESSAGE("toHex: " + toString(megabytes / encode) + " MB/s, byte at a time: " +
+                     toString(megabytes / scalarEncode) + " MB/s");
+    ETH_TEST_MESSAGE("fromHex: " + toString(megabytes / decode) + " MB/s, byte at a time: " +
+                     toString(megabytes / scalarDecode) + " MB/s");
+}
+
+BOOST_AUTO_TEST_CASE(u256_sameAsBoost)
+{
+    // Random bit lengths cover the numbers of every limb count
+    std::mt19937_64 random(13);
+    for (size_t round = 0; round < 5000; round++)
+    {
+        u256 value = (u256(random()) << 192) | (u256(random()) << 128) | (u256(random()) << 64) | random();
+        size_t const bits = random() % 257;
+        if (bits < 256)
+            value &= (u256(1) << bits) - 1;
+        unsigned const minBytes = random() % 34;
+
+        bytes const compact = toCompactBigEndian(value, minBytes);
+        ETH_REQUIRE(toCompactHex(value, minBytes) == toHex(compact.begin(), compact.end(), ""));
+        ETH_REQUIRE(toCompactHexPrefixed(value, minBytes) == toHex(compact.begin(), compact.end(), "0x"));
+
+        string const decimal = value.str();
+        string const hex = toCompactHexPrefixed(value, random() % 3);
+        ETH_REQUIRE(toU256(decimal) == u256(decimal));
+        ETH_REQUIRE(toU256(hex) == u256(hex));
+        ETH_REQUIRE(toU256(boost::to_upper_copy(hex.substr(2)).insert(0, "0x")) == value);
+    }
+
+    // numbers that are left to the boost parser, or that it rejects
+    vector<string> const numbers = {"0", "00", "010", "0x", "0x0", "0X1f", "0xg", "12a", "-1", " 1",
+        "0x" + string(64, 'f'), "0x1" + string(64, '0'), string(77, '9'), string(78, '9')};
+    for (string const& number : numbers)
+    {
+        string expected;
+        string result;
+        try
+        {
+            expected = u256(number).str();
+        }
+        catch (std::exception const&)
+        {
+            expected = "error";
+        }
+        try
+        {
+            result = toU256(number).str();
+        }
+        catch (std::exception const&)
+        {
+            result = "error";
+        }
+        ETH_REQUIRE_MESSAGE(result == expected, "toU256(\"" + number + "\") is " + result);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha3Batch_sameAsSha3)
+{
+    // Mostly addresses and slots, some inputs of several blocks and the padding boundaries
+    std::mt19937 random(17);
+    size_t const sizes[] = {0, 1, 20, 32, 64, 135, 136, 137, 271, 272, 500};
+    for (size_t round = 0; round < 300; round++)
+    {
+        vector<bytes> data(random() % 40);
+        for (auto& d : data)
+        {
+            d.resize(sizes[random() % (sizeof(sizes) / sizeof(sizes[0]))]);
+            for (auto& b : d)
+                b = byte(random());
+        }
+        vector<bytesConstRef> inputs;
+        for (auto const& d : data)
+            inputs.push_back(bytesConstRef(&d));
+
+        h256s const hashes = sha3Batch(inputs);
+        ETH_REQUIRE(hashes.size() == inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++)
+            ETH_REQUIRE(hashes[i] == sha3(inputs[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha3Batch_throughput)
+{
+    std::mt19937 random(19);
+    for (size_t size : {20, 32, 64, 200})
+    {
+        vector<bytes> data(100000, bytes(size));
+        for (auto& d : data)
+            for (auto& b : d)
+                b = byte(random());
+        vector<bytesConstRef> inputs;
+        for (auto const& d : data)
+            inputs.push_back(bytesConstRef(&d));
+
+        dev::Timer timer;
+        h256s loop(inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++)
+            loop[i] = sha3(inputs[i]);
+        double const loopTime = timer.elapsed();
+        timer.restart();
+        h256s const batch = sha3Batch(inputs);
+        double const batchTime = timer.elapsed();
+
+        ETH_REQUIRE(batch == loop);
+        ETH_TEST_MESSAGE("sha3Batch of " + toString(size) + " bytes: " +
+                         toString(inputs.size() / batchTime / 1e6) + " M hashes/s, sha3 loop: " +
+                         toString(inputs.size() / loopTime / 1e6) + " M hashes/s");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testFileLoader_failedLoads)
+{
+    // Failed loads give nullptr and leave no errors on the loader threads, those would fail
+    // this test when the errors of all threads are collected
+    vector<TestFileLoader::LoadFunction> loaders;
+    loaders.push_back([]() {
+        TestFileData data;
+        data.data["test"] = "value";
+        return data;
+    });
+    loaders.push_back([]() {
+        TestFileData data;
+        data.test = std::make_shared<DataObject>(DataType::Object);
+        return data;
+    });
+    loaders.push_back([]() {
+        ETH_ERROR("Failed to parse json file");
+        return TestFileData();
+    });
+    loaders.push_back([]() -> TestFileData { throw std::exception(); });
+    loaders.push_back([]() { return TestFileData(); });
+    loaders.push_back(TestFileLoader::LoadFunction());
+
+    TestFileLoader loader(loaders, 2);
+    std::shared_ptr<TestFileData> const loaded = loader.next();
+    ETH_REQUIRE(loaded && loaded->data.at("test").asString() == "value");
+    ETH_REQUIRE(loader.next() != nullptr);  // only the filled test is given
+    for (size_t i = 2; i < loaders.size(); i++)
+        ETH_REQUIRE(!loader.next());
+}
+
+BOOST_AUTO_TEST_CASE(lllCompiler_diskCache)
+{
+    // A fake lllc on PATH counts its compilations
+    namespace fs = boost::filesystem;
+    fs::path const dir = fs::temp_directory_path() / fs::unique_path();
+    fs::path const cache = dir / "lllcCache";
+    fs::path const calls = dir / "calls";
+    writeFile(dir / "lllc", asBytes(
+        "#!/bin/sh\n"
+        "if [ \"$1\" = \"--version\" ]; then echo 'lllc 0.4.0'; exit 0; fi\n"
+        "echo x >> " + calls.string() + "\n"
+        "if grep -q fail \"$1\"; then exit 1; fi\n"
+        "echo 6001600055\n"), true);
+    fs::permissions(dir / "lllc", fs::owner_all);
+    string const path = getenv("PATH") ? getenv("PATH") : "";
+    setenv("PATH", (dir.string() + ":" + path).c_str(), 1);
+    auto callCount = [&calls]() {
+        string const lines = fs::exists(calls) ? contentsString(calls) : string();
+        return count(lines.begin(), lines.end(), '\n');
+    };
+
+    string const code = "{ [[0]] 1 }";
+    {
+        LLLCompiler compiler(cache, true);
+        ETH_REQUIRE(compiler.compile(code) == "0x6001600055");
+        ETH_REQUIRE(compiler.compile(code) == "0x6001600055");
+        ETH_REQUIRE(callCount() == 1);
+    }
+    {
+        // The next run takes the bytecode from the disk
+        LLLCompiler compiler(cache, true);
+        ETH_REQUIRE(compiler.compile(code) == "0x6001600055");
+        ETH_REQUIRE(callCount() == 1);
+    }
+
+    // A truncated entry is compiled again
+    ETH_REQUIRE(fs::directory_iterator(cache) != fs::directory_iterator());
+    fs::path const entry = fs::directory_iterator(cache)->path();
+    string const stored = contentsString(entry);
+    writeFile(entry, asBytes(stored.substr(0, stored.size() - 2)));
+    {
+        LLLCompiler compiler(cache, true);
+        ETH_REQUIRE(compiler.compile(code) == "0x6001600055");
+        ETH_REQUIRE(callCount() == 2);
+        ETH_REQUIRE(contentsString(entry) == stored);
+    }
+    {
+        LLLCompiler compiler(cache, false);
+        ETH_REQUIRE(compiler.compile(code) == "0x6001600055");
+        ETH_REQUIRE(callCount() == 3);
+
+        // The compilation error is reported on this thread
+        size_t const errorCount = TestOutputHelper::get().getErrors().size();
+        compiler.compile("{ fail }");
+        ETH_REQUIRE(TestOutputHelper::get().getErrors().size() == errorCount + 1);
+        TestOutputHelper::get().dropErrors(errorCount);
+    }
+
+    setenv("PATH", path.c_str(), 1);
+    fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(testSharding_mergeOverlappingShards)
+{
+    namespace fs = boost::filesystem;
+    fs::path const dir = fs::temp_directory_path() / fs::unique_path();
+    fs::path const shard1 = dir / "shard1.json";
+    fs::path const shard2 = dir / "shard2.json";
+    fs::path const broken = dir / "broken.json";
+    fs::path const output = dir / "merged.json";
+    writeFile(shard1, asBytes(R"({"shard": "1/2", "tests": {
+        "stA": {"time": 1, "errors": []},
+        "stB": {"time": 2, "errors": []}}})"), true);
+    writeFile(shard2, asBytes(R"({"shard": "2/2", "tests": {
+        "stB": {"time": 3, "errors": []},
+        "stC": {"time": 4, "errors": ["wrong balance"]}}})"), true);
+    writeFile(broken, asBytes("{\"shard\": "), true);
+
+    // stB executed twice and the failed stC
+    ETH_REQUIRE(TestSharding::mergeResults({shard1.string(), shard2.string()}, output) == 2);
+    Json::Value merged;
+    ETH_REQUIRE(Json::Reader().parse(contentsString(output), merged));
+    Json::Value const& tests = merged["tests"];
+    ETH_REQUIRE(tests.size() == 3);
+    ETH_REQUIRE(tests["stB"]["shard"].asString() == "1/2");
+    ETH_REQUIRE(tests["stB"]["time"].asDouble() == 2);
+    ETH_REQUIRE(tests["stB"]["errors"].size() == 1);
+
+    // The same shard given twice, a file that is not a shard result and a missing file
+    ETH_REQUIRE(TestSharding::mergeResults({shard1.string(), shard1.string()}, fs::path()) == 1);
+    ETH_REQUIRE(TestSharding::mergeResults({shard1.string(), broken.string()}, fs::path()) == 1);
+    ETH_REQUIRE(TestSharding::mergeResults(
+                    {shard1.string(), (dir / "missing.json").string()}, fs::path()) == 1);
+    ETH_REQUIRE(TestSharding::mergeResults({shard1.string()}, fs::path()) == 0);
+    fs::remove_all(dir);
+}
+
+namespace
+{
+/// Execute the files of _queue until it is done. The results of _failingFile have an error
+void runWorker(string const& _address, string const& _queue, string const& _failingFile)
+{
+    TestWorker worker(_address);
+    size_t taskId;
+    boost::filesystem::path file;
+    while (true)
+    {
+        TestWorker::TaskStatus const status = worker.requestTask(_queue, taskId, file);
+        if (status == TestWorker::TaskStatus::Done)
+            break;
+        if (status == TestWorker::TaskStatus::Wait)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        else if (file.string() == _failingFile)
+            worker.sendResult(taskId, 1, {"wrong balance"});
+        else
+            worker.sendResult(taskId, 1, {});
+    }
+}
+
+/// Take a task of _queue and disconnect without its result
+void runLostWorker(string const& _address, string const& _queue)
+{
+    TestWorker worker(_address);
+    size_t taskId;
+    boost::filesystem::path file;
+    while (worker.requestTask(_queue, taskId, file) == TestWorker::TaskStatus::Wait)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(distributedTests_requeueLostTask)
+{
+    TestCoordinator coordinator(0);
+    string const address = "127.0.0.1:" + toString(coordinator.port());
+    std::thread workers([&address]() {
+        runLostWorker(address, "stExample");
+        runWorker(address, "stExample", "b.json");
+    });
+
+    map<string, vector<string>> results;
+    coordinator.runTasks("stExample", {"a.json", "b.json", "c.json"},
+        [&results](TestCoordinator::TaskResult const& _result) {
+            ETH_REQUIRE(!results.count(_result.file.string()));
+            results[_result.file.string()] = _result.errors;
+        });
+    workers.join();
+
+    // a.json is taken by the lost worker and executed by the next one
+    ETH_REQUIRE(results.size() == 3);
+    ETH_REQUIRE(results.at("a.json").empty());
+    ETH_REQUIRE(results.at("b.json") == vector<string>{"wrong balance"});
+    ETH_REQUIRE(results.at("c.json").empty());
+}
+
+BOOST_AUTO_TEST_CASE(distributedTests_noWorkersLeft)
+{
+    TestCoordinator coordinator(0, 2);
+    string const address = "127.0.0.1:" + toString(coordinator.port());
+    std::thread worker(runLostWorker, address, "stExample");
+
+    // The lost task is requeued, but nobody takes it
+    vector<TestCoordinator::TaskResult> results;
+    coordinator.runTasks("stExample", {"a.json", "b.json"},
+        [&results](TestCoordinator::TaskResult const& _result) { results.push_back(_result); });
+    worker.join();
+
+    ETH_REQUIRE(results.size() == 2);
+    for (auto const& result : results)
+        ETH_REQUIRE(result.errors.size() == 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 